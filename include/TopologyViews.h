@@ -28,6 +28,9 @@ struct CoefficientViews
   using nodal_matrix_array = Kokkos::View<real_type[nodes1D][nodes1D]>;
   using linear_nodal_matrix_array = Kokkos::View<real_type[2][p+1]>;
   using linear_scs_matrix_array = Kokkos::View<real_type[2][p]>;
+
+  // product of two nodal matrices that keeps the summation index, e.g. W(n,k) D(k,j)
+  using nodal_matrix_product_array = Kokkos::View<real_type[nodes1D][nodes1D][nodes1D]>;
 };
 
 
@@ -69,6 +72,36 @@ struct QuadViews
   using scs_tensor_array = Kokkos::View<real_type[dim][dim][p][nodes1D]>;
 };
 
+// number of elements handled together by the batched kernels, one per SIMD lane
+#if defined(__AVX512F__)
+constexpr int simd_lanes = 8;
+#else
+constexpr int simd_lanes = 4;
+#endif
+
+template <unsigned p>
+struct QuadBatchViews
+{
+  // same arrays as QuadViews, with an innermost dimension over a batch of elements
+  constexpr static int poly_order = p;
+  constexpr static int nodes1D = p + 1;
+  constexpr static int dim = 2;
+  constexpr static int nodesPerElement = nodes1D * nodes1D;
+  constexpr static int lanes = simd_lanes;
+  using real_type = double;
+
+  // the layout is spelled out so that, e.g., a batch of quads with lanes == nodes1D
+  // is a different type from a hex array and the kernel overloads stay unambiguous
+  using layout_type = Kokkos::LayoutRight;
+
+  // arrays for nodal variables
+  using nodal_scalar_array = Kokkos::View<real_type[nodes1D][nodes1D][lanes], layout_type>;
+  using nodal_vector_array = Kokkos::View<real_type[dim][nodes1D][nodes1D][lanes], layout_type>;
+
+  // arrays for variables evaluated at subcontrol surfaces in one  direction
+  using scs_tensor_array = Kokkos::View<real_type[dim][dim][p][nodes1D][lanes], layout_type>;
+};
+
 template <unsigned p>
 struct HexViews
 {
@@ -89,7 +122,7 @@ struct HexViews
 
   // arrays for variables evaluated at subcontrol surfaces in one direction, e.g.
   // at a constant xhat surface
-  using scs_scalar_array = Kokkos::View<real_type[p][nodes1D]>;
+  using scs_scalar_array = Kokkos::View<real_type[p][nodes1D][nodes1D]>;
   using scs_vector_array = Kokkos::View<real_type[dim][p][nodes1D][nodes1D]>;
   using scs_tensor_array = Kokkos::View<real_type[dim][dim][p][nodes1D][nodes1D]>;
 };
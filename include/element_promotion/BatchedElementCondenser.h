@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef BatchedElementCondenser_h
+#define BatchedElementCondenser_h
+
+#include <stddef.h>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+  struct ElementDescription;
+
+  class BatchedElementCondenser
+  {
+    /*
+     * Static condensation of many elements at once.  Elements are processed in groups of
+     * batch_size(), with the element as the fastest-varying index of the work arrays, so the
+     * LU factorization of L_II and the Schur-complement update vectorize across elements
+     * instead of relying on LAPACK calls sized (p-1)^dim.
+     *
+     * Uses the same conventions as ElementCondenser: row-major elemental matrices with the
+     * interior nodes last, column-major condensed matrices
+     */
+  public:
+    BatchedElementCondenser(const ElementDescription& elem);
+
+    // lhs and rhs hold numElements contiguous elemental systems.  If interior_coupling and
+    // interior_rhs are given, L_II^-1 L_IB (column-major) and L_II^-1 f_I are returned as well
+    void condense(
+      size_t numElements,
+      const double* lhs,
+      const double* rhs,
+      double* r_lhs,
+      double* r_rhs,
+      double* interior_coupling = nullptr,
+      double* interior_rhs = nullptr
+    );
+
+    int batch_size() const;
+    int num_boundary_nodes() const { return nb_; }
+    int num_internal_nodes() const { return ni_; }
+    int nodes_per_element() const { return ne_; }
+
+  private:
+    void condense_batch(
+      size_t numElements,
+      const double* lhs,
+      const double* rhs,
+      double* r_lhs,
+      double* r_rhs,
+      double* interior_coupling,
+      double* interior_rhs
+    );
+    void gather(size_t numElements, const double* lhs, const double* rhs);
+    void solve_interior();
+    void update_boundary();
+
+    int nb_;
+    int ni_;
+    int ne_;
+
+    // [L_II | L_IB | f_I] and [L_BI | L_BB | f_B], element-fastest
+    std::vector<double> interior_;
+    std::vector<double> boundary_;
+  };
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef CrsMatrix_h
+#define CrsMatrix_h
+
+#include <stddef.h>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+  class CrsMatrix
+  {
+    /*
+     * Compressed-row global matrix for element-based assembly.  The sparsity pattern
+     * and the slot of each elemental matrix entry in the values array are computed once
+     * from the element connectivity, so repeated assemblies only add into the values
+     */
+  public:
+    // elemRows holds the global row of each element node, elemRows[e * nodesPerElement + n]
+    CrsMatrix(size_t numRows, std::vector<int> elemRows, int nodesPerElement);
+
+    void zero();
+
+    // adds a row-major elemental matrix, lhs_local[row * nodesPerElement + col]
+    void sum_into(size_t elem, const double* lhs_local);
+
+    // adds a column-major elemental matrix, lhs_local[row + nodesPerElement * col]
+    void sum_into_transpose(size_t elem, const double* lhs_local);
+
+    // zeros the row and puts a one on the diagonal
+    void set_identity_row(size_t row);
+
+    void apply(const std::vector<double>& x, std::vector<double>& y) const;
+
+    double diagonal(size_t row) const { return values_[diagonalSlot_[row]]; }
+    const int* element_rows(size_t elem) const { return &elemRows_[elem * nodesPerElement_]; }
+
+    size_t num_rows() const { return numRows_; }
+    size_t num_elements() const { return numElements_; }
+    size_t num_nonzeros() const { return columns_.size(); }
+    int nodes_per_element() const { return nodesPerElement_; }
+
+    const std::vector<int>& row_offsets() const { return rowOffsets_; }
+    const std::vector<int>& column_indices() const { return columns_; }
+    const std::vector<double>& values() const { return values_; }
+
+  private:
+    void build_graph();
+    void build_scatter_map();
+
+    const size_t numRows_;
+    const int nodesPerElement_;
+    const std::vector<int> elemRows_;
+    const size_t numElements_;
+
+    std::vector<int> rowOffsets_;
+    std::vector<int> columns_;
+    std::vector<double> values_;
+    std::vector<int> diagonalSlot_;
+
+    // slot in values_ of each entry of each elemental matrix, row-major
+    std::vector<int> scatterMap_;
+  };
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
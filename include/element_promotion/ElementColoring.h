@@ -0,0 +1,27 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef ElementColoring_h
+#define ElementColoring_h
+
+#include <stddef.h>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+  // Greedy coloring of the elements such that no two elements of the same color share a node.
+  // Elements of one color can be summed into a global system concurrently without locks or atomics.
+  // elemRows holds the global row of each element node, elemRows[e * nodesPerElement + n]
+  std::vector<std::vector<size_t>> color_elements(
+    const std::vector<int>& elemRows,
+    int nodesPerElement,
+    size_t numRows);
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
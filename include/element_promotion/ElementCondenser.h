@@ -13,6 +13,8 @@
 #include <Teuchos_SerialDenseMatrix.hpp>
 #include <Teuchos_SerialDenseSolver.hpp>
 
+#include <stddef.h>
+#include <vector>
 
 namespace sierra {
 namespace naluUnit {
@@ -22,15 +24,59 @@ namespace naluUnit {
   class ElementCondenser
   {
   public:
-    ElementCondenser(const ElementDescription& elem);
+    // what is kept for an element between its condensation and its interior update
+    enum StoredFactors {
+      NO_FACTORS,       // the interior update re-extracts and re-factors L_II
+      INTERIOR_LU,      // LU factors of L_II (or its fast diagonalization), so the update is a solve
+      INTERIOR_COUPLING // L_II^-1 L_IB and L_II^-1 f_I, so the update is a GEMV
+    };
+
+    // Factors are kept for up to numElements elements, within memoryBudget bytes.
+    // If not every element fits, the oldest stored element is evicted
+    ElementCondenser(
+      const ElementDescription& elem,
+      size_t numElements = 0,
+      size_t memoryBudget = 0
+    );
+
+    void condense(
+      double* lhs,
+      const double* rhs,
+      double* r_lhs,
+      double* r_rhs
+    );
+
+    // condenses and stores the factors of element "elem"
+    void condense(
+      size_t elem,
+      double* lhs,
+      const double* rhs,
+      double* r_lhs,
+      double* r_rhs
+    );
 
+    // For an affine element with orthogonal edges, the diffusion metric is diagonal and constant,
+    // and L_II = sum_d a_d (W x ... x K x ... x W) with the 1D CVFEM operators W and K in the
+    // d-th slot.  Given axis_scales[d] = a_d, L_II^-1 is applied by fast diagonalization from
+    // the eigen-decomposition of W^-1 K instead of an LU of L_II.  Without axis_scales, or if
+    // the 1D operators don't have a real eigen-decomposition, this is the LU condensation
     void condense(
+      size_t elem,
+      const double* axis_scales,
       double* lhs,
       const double* rhs,
       double* r_lhs,
       double* r_rhs
     );
 
+    // stores L_II^-1 L_IB (column-major) and L_II^-1 f_I computed elsewhere, e.g. by
+    // BatchedElementCondenser.  Nothing is kept unless the store type is INTERIOR_COUPLING
+    void store_interior_coupling(
+      size_t elem,
+      const double* coupling,
+      const double* interior_rhs
+    );
+
     void compute_interior_update(
       double* lhs,
       const double* boundary_values,
@@ -38,6 +84,34 @@ namespace naluUnit {
       double* interior_values
     );
 
+    // dq_I = L_II^-1 f_I - (L_II^-1 L_IB) dq_B, for an element with INTERIOR_COUPLING
+    void compute_interior_update(
+      size_t elem,
+      const double* boundary_update,
+      double* interior_update
+    );
+
+    // dq_I = L_II^-1 r_I for an element with INTERIOR_LU, given
+    // the elemental residual evaluated with the updated boundary values
+    void solve_interior(
+      size_t elem,
+      const double* rhs,
+      double* interior_update
+    );
+
+    StoredFactors stored_factors(size_t elem) const
+    {
+      return (elem < entryOfElement_.size() && entryOfElement_[elem] >= 0) ? storeType_ : NO_FACTORS;
+    }
+
+    bool has_fast_diagonalization() const { return fastDiagonalization_; }
+    size_t num_fast_diagonalized() const { return numFastDiagonalized_; }
+
+    StoredFactors store_type() const { return storeType_; }
+    size_t num_evictions() const { return numEvictions_; }
+    size_t num_stored() const { return numStored_; }
+    size_t store_bytes() const { return store_.size() * sizeof(double); }
+
     int num_boundary_nodes()
     {
       return nb_;
@@ -56,6 +130,14 @@ namespace naluUnit {
   private:
     void chunk(const double* lhs, const double* rhs, double* b_lhs, double* b_rhs);
     void chunk_lower(const double* lhs, const double* rhs);
+    void setup_store(size_t numElements, size_t memoryBudget);
+    void setup_fast_diagonalization(const ElementDescription& elem);
+    double* acquire_entry(size_t elem, size_t size, bool fastDiagonalized);
+    void evict_oldest_entry();
+    void condense_element(const double* axis_scales, const double* lhs, const double* rhs, double* b_lhs, double* b_rhs);
+    void store_factors(size_t elem, const double* axis_scales);
+    void apply_1D(const double* op, int axis, int ncol, const double* in, double* out) const;
+    void solve_fast_diagonalization(const double* axis_scales, double* x, int ncol);
 
     Teuchos::BLAS<int,double> blas_;
     Teuchos::LAPACK<int,double> lapack_;
@@ -69,7 +151,38 @@ namespace naluUnit {
     int nb_;
     int ni_;
     int ne_;
-
+    int dim_;
+
+    // fast diagonalization of the interior 1D operators, W^-1 K = V diag(lambda) V^-1.
+    // Matrices are column-major and (p-1) x (p-1), with Q = (W V)^-1
+    bool fastDiagonalization_;
+    int interior1D_;
+    std::vector<double> eigenvalues_;
+    std::vector<double> eigenvectors_;
+    std::vector<double> inverseTransform_;
+    std::vector<int> interiorOrdinal_;
+    std::vector<double> fdmWork_;
+    std::vector<double> fdmInvDiag_;
+    size_t numFastDiagonalized_;
+
+    // per-element factors, written one after the other around store_ and evicted oldest first.
+    // Each entry is sized by what it holds: L_II^-1 L_IB and L_II^-1 f_I, the LU factors
+    // and pivots of L_II, or only the axis scales of a fast-diagonalized element
+    struct StoredEntry {
+      size_t elem;  // past the last element once the entry is superseded
+      size_t offset;
+      size_t size;
+      bool fastDiagonalized;
+    };
+    StoredFactors storeType_;
+    std::vector<double> store_;
+    size_t storeHead_;
+    std::vector<StoredEntry> entries_; // ring, oldest first
+    size_t firstEntry_;
+    size_t numEntries_;
+    std::vector<int> entryOfElement_;
+    size_t numStored_;
+    size_t numEvictions_;
   };
 
 } // namespace nalu
@@ -0,0 +1,53 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef ElementCondenserTest_h
+#define ElementCondenserTest_h
+
+#include <element_promotion/ElementDescription.h>
+
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+class ElementCondenserTest
+{
+public:
+  // constructor/destructor
+  ElementCondenserTest(int dim, int polyOrder, size_t numElements = 64);
+  ~ElementCondenserTest() = default;
+
+  void execute();
+
+  bool check_batched_condensation(double tol);
+  bool check_stored_coupling(double tol);
+  void benchmark_condensation();
+
+  // elemental Laplacian of an axis-aligned box, from the tensor-product assembly
+  void separable_laplacian(const double* axisScales, std::vector<double>& lhs);
+  template <unsigned poly_order> void separable_laplacian(const double* axisScales, std::vector<double>& lhs);
+  bool check_fast_diagonalization(double tol);
+  bool check_mixed_factor_store(double tol);
+  void benchmark_fast_diagonalization();
+
+  unsigned nDim_;
+  unsigned polyOrder_;
+  size_t numElements_;
+  bool outputTiming_;
+  std::shared_ptr<const ElementDescription> elem_;
+
+  // row-major elemental systems with the interior nodes last, one after the other
+  std::vector<double> lhs_;
+  std::vector<double> rhs_;
+};
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
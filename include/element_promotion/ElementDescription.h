@@ -8,25 +8,38 @@
 #ifndef ElementDescription_h
 #define ElementDescription_h
 
+#include <element_promotion/FlatOrdinalMap.h>
 #include <element_promotion/LagrangeBasis.h>
 #include <element_promotion/TensorProductQuadratureRule.h>
 
 #include <stddef.h>
-#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace sierra {
 namespace naluUnit {
 
-typedef std::map<std::vector<size_t>, std::vector<size_t>> AddedConnectivityOrdinalMap;
-typedef std::map<std::vector<size_t>, std::vector<std::vector<double>>> AddedNodeLocationsMap;
+// added node ordinals -> base element ordinals / isoparametric locations of the added nodes,
+// (node, direction) with as many directions as the edge, face or volume has
+typedef FlatOrdinalMap<size_t> AddedConnectivityOrdinalMap;
+typedef FlatOrdinalMap<double> AddedNodeLocationsMap;
 typedef std::vector<std::vector<size_t>> SubElementConnectivity;
 
 struct ElementDescription
 {
 public:
-  static std::unique_ptr<ElementDescription> create(
+  // description of the element type shared by all of its users, built on first use
+  // and freed once nothing refers to it
+  static std::shared_ptr<const ElementDescription> create(
+    int dimension,
+    int order,
+    std::string quadType = "GaussLegendre",
+    bool useReducedGeometricBasis = false
+  );
+
+  // a new description that is not shared with anything else
+  static std::unique_ptr<ElementDescription> build(
     int dimension,
     int order,
     std::string quadType = "GaussLegendre",
@@ -109,6 +122,16 @@ public:
     return basis->eval_deriv_weights(intgLoc);
   }
 
+  void eval_basis_weights(size_t numIps, const double* intgLoc, double* weights) const
+  {
+    basis->eval_basis_weights(numIps, intgLoc, weights);
+  }
+
+  void eval_deriv_weights(size_t numIps, const double* intgLoc, double* derivWeights) const
+  {
+    basis->eval_deriv_weights(numIps, intgLoc, derivWeights);
+  }
+
   std::vector<double> scsLoc;
   std::vector<double> nodeLocs;
 
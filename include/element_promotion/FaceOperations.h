@@ -1,6 +1,8 @@
 #ifndef FaceOperations_h
 #define FaceOperations_h
 
+#include <element_promotion/FlatOrdinalMap.h>
+
 #include <stddef.h>
 #include <vector>
 #include <stk_util/environment/ReportHandler.hpp>
@@ -17,7 +19,7 @@ namespace naluUnit {
   template<typename T> bool
   parents_are_reversed(
     const std::vector<T>& test,
-    const std::vector<T>& gold)
+    ArrayView<T> gold)
   {
     const unsigned numParents = gold.size();
     ThrowAssert(test.size() == numParents);
@@ -51,7 +53,7 @@ namespace naluUnit {
   template<typename T> bool
   parents_are_flipped_x(
     const std::vector<T>& test,
-    const std::vector<T>& gold,
+    ArrayView<T> gold,
     unsigned size1D)
   {
     ThrowAssert(test.size() == gold.size());
@@ -91,7 +93,7 @@ namespace naluUnit {
   template<typename T> bool
   parents_are_flipped_y(
     const std::vector<T>& test,
-    const std::vector<T>& gold,
+    ArrayView<T> gold,
     unsigned size1D)
   {
     ThrowAssert(test.size() == gold.size());
@@ -113,7 +115,7 @@ namespace naluUnit {
   template<typename T> bool
   should_transpose(
     const std::vector<T>& test,
-    const std::vector<T>& gold)
+    ArrayView<T> gold)
   {
     ThrowAssert(test.size() == gold.size());
     if (test.size() != 4) {
@@ -145,7 +147,7 @@ namespace naluUnit {
   template<typename T> bool
   should_invert(
     const std::vector<T>& test,
-    const std::vector<T>& gold)
+    ArrayView<T> gold)
   {
     ThrowAssert(test.size() == gold.size());
     if (test.size() != 4) {
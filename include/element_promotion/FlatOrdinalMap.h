@@ -0,0 +1,156 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef FlatOrdinalMap_h
+#define FlatOrdinalMap_h
+
+#include <stk_util/environment/ReportHandler.hpp>
+
+#include <stddef.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+  template <typename T>
+  class ArrayView
+  {
+    // non-owning view of a contiguous, read-only range
+  public:
+    ArrayView() = default;
+    ArrayView(const T* data, size_t size) : data_(data), size_(size) {}
+    ArrayView(const std::vector<T>& vec) : data_(vec.data()), size_(vec.size()) {}
+
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+    bool operator==(ArrayView other) const
+    {
+      return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(ArrayView other) const { return !(*this == other); }
+
+    std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+  private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  template <typename T>
+  class FlatOrdinalMap
+  {
+    /*
+     * Read-only map from a list of node ordinals to a list of values, e.g. from the ordinals
+     * of the nodes added to an edge to the ordinals of the edge's end nodes.  The keys and
+     * values of every entry are stored back to back in two contiguous arrays, in the order
+     * of the std::map the table is built from.
+     *
+     * The key lists of a table are disjoint---each added node belongs to exactly one edge,
+     * face or volume---so the first ordinal of a key identifies its entry and lookups are a
+     * single index into a table sized by the largest ordinal
+     */
+  public:
+    struct Entry
+    {
+      ArrayView<size_t> first;
+      ArrayView<T> second;
+    };
+
+    class const_iterator
+    {
+    public:
+      const_iterator(const FlatOrdinalMap* map, size_t index) : map_(map), index_(index) {}
+      Entry operator*() const { return map_->entry(index_); }
+      const_iterator& operator++() { ++index_; return *this; }
+      bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+      bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+    private:
+      const FlatOrdinalMap* map_;
+      size_t index_;
+    };
+
+    FlatOrdinalMap() = default;
+
+    explicit FlatOrdinalMap(const std::map<std::vector<size_t>, std::vector<T>>& map)
+    {
+      keyOffsets_.reserve(map.size() + 1);
+      valueOffsets_.reserve(map.size() + 1);
+      keyOffsets_.push_back(0);
+      valueOffsets_.push_back(0);
+
+      for (const auto& relation : map) {
+        const auto& key = relation.first;
+        const int entryIndex = keyOffsets_.size() - 1;
+        if (key.empty()) {
+          emptyKeyEntry_ = entryIndex;
+        }
+        else {
+          if (entryForOrdinal_.size() <= key[0]) {
+            entryForOrdinal_.resize(key[0] + 1, -1);
+          }
+          ThrowRequireMsg(entryForOrdinal_[key[0]] < 0, "Ordinal lists of a FlatOrdinalMap must be disjoint");
+          entryForOrdinal_[key[0]] = entryIndex;
+        }
+        keys_.insert(keys_.end(), key.begin(), key.end());
+        values_.insert(values_.end(), relation.second.begin(), relation.second.end());
+        keyOffsets_.push_back(keys_.size());
+        valueOffsets_.push_back(values_.size());
+      }
+    }
+
+    size_t size() const { return keyOffsets_.empty() ? 0 : keyOffsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    Entry entry(size_t index) const
+    {
+      return Entry{
+        ArrayView<size_t>(keys_.data() + keyOffsets_[index], keyOffsets_[index + 1] - keyOffsets_[index]),
+        ArrayView<T>(values_.data() + valueOffsets_[index], valueOffsets_[index + 1] - valueOffsets_[index])
+      };
+    }
+
+    // returns -1 if there is no entry for the ordinals
+    int find(ArrayView<size_t> ordinals) const
+    {
+      int index = emptyKeyEntry_;
+      if (!ordinals.empty()) {
+        index = (ordinals[0] < entryForOrdinal_.size()) ? entryForOrdinal_[ordinals[0]] : -1;
+      }
+      return (index >= 0 && entry(index).first == ordinals) ? index : -1;
+    }
+
+    bool count(ArrayView<size_t> ordinals) const { return find(ordinals) >= 0; }
+
+    ArrayView<T> at(ArrayView<size_t> ordinals) const
+    {
+      const int index = find(ordinals);
+      ThrowRequireMsg(index >= 0, "No entry for the requested ordinals");
+      return entry(index).second;
+    }
+
+  private:
+    std::vector<size_t> keyOffsets_;
+    std::vector<size_t> keys_;
+    std::vector<size_t> valueOffsets_;
+    std::vector<T> values_;
+    std::vector<int> entryForOrdinal_;
+    int emptyKeyEntry_ = -1;
+  };
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
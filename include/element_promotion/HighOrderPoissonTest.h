@@ -10,11 +10,8 @@
 #include <stk_mesh/base/Field.hpp>
 #include <stk_mesh/base/CoordinateSystems.hpp>
 
-#include <Teuchos_SerialDenseVector.hpp>
-#include <Teuchos_SerialDenseMatrix.hpp>
-#include <Teuchos_SerialDenseSolver.hpp>
-
 #include <stddef.h>
+#include <map>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -22,6 +19,9 @@
 
 namespace sierra {
 namespace naluUnit {
+  class BatchedElementCondenser;
+  class CrsMatrix;
+  class ElementCondenser;
   class MasterElement;
   class PromoteElement;
   class PromotedElementIO;
@@ -79,13 +79,13 @@ public:
 
   void solve_poisson();
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   make_master_volume_element(const ElementDescription& elem);
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   make_master_subcontrol_surface_element(const ElementDescription& elem);
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   make_master_boundary_element(const ElementDescription& elem);
 
   bool check_solution();
@@ -95,12 +95,13 @@ public:
   const bool outputTiming_;
   double timeCondense_;
   double timeInteriorUpdate_;
+  bool solverConverged_;
   const double testTolerance_;
   const bool randomlyPerturbCoordinates_;
 
   std::string fineOutputName_;
 
-  std::unique_ptr<ElementDescription> elem_;
+  std::shared_ptr<const ElementDescription> elem_;
   std::unique_ptr<PromotedElementIO> promoteIO_;
 
   // meta, bulk, io, and promote element
@@ -119,12 +120,14 @@ public:
   stk::mesh::PartVector superPartVector_;
   stk::mesh::PartVector superSidePartVector_;
 
-  Teuchos::SerialDenseMatrix<int,double> lhs_;
-  Teuchos::SerialDenseVector<int,double> rhs_;
-  Teuchos::SerialDenseVector<int,double> delta_;
+  std::unique_ptr<CrsMatrix> lhs_;
+  std::unique_ptr<ElementCondenser> condenser_;
+  std::unique_ptr<BatchedElementCondenser> batchedCondenser_;
+  std::vector<double> rhs_;
+  std::vector<double> delta_;
   std::map<stk::mesh::Entity, size_t> rowMap_;
-  std::unique_ptr<MasterElement> meSCS_;
-  std::unique_ptr<MasterElement> meSCV_;
+  std::shared_ptr<const MasterElement> meSCS_;
+  std::shared_ptr<const MasterElement> meSCV_;
 
 
 private:
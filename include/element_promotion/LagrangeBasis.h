@@ -7,6 +7,7 @@
 #ifndef LagrangeBasis_h
 #define LagrangeBasis_h
 
+#include <stddef.h>
 #include <vector>
 
 namespace sierra{
@@ -27,6 +28,13 @@ public:
 
   double derivative_weight(double x, unsigned nodeNumber) const;
 
+  // the weights of all of the nodes at x, O(n^2) in the number of nodes
+  void interpolation_weights(double x, double* weights) const;
+  void derivative_weights(double x, double* weights) const;
+  void weights(double x, double* interpWeights, double* derivWeights) const;
+
+  unsigned num_nodes() const { return nodeLocs_.size(); }
+
 private:
   void set_lagrange_weights();
   std::vector<double> lagrangeWeights_;
@@ -49,6 +57,20 @@ public:
   std::vector<double> eval_deriv_weights(
     const std::vector<double>& intgLoc) const;
 
+  // caller-provided storage: intgLoc(ip, dim), weights(ip, node) and derivWeights(ip, node, dim).
+  // The 1D bases are evaluated once per ip and direction, and the tensor products formed from those
+  void eval_basis_weights(
+    size_t numIps,
+    const double* intgLoc,
+    double* weights) const;
+
+  void eval_deriv_weights(
+    size_t numIps,
+    const double* intgLoc,
+    double* derivWeights) const;
+
+  size_t num_nodes() const { return indicesMap_.size(); }
+
   double tensor_lagrange_derivative(
     unsigned dimension,
     const double* x,
@@ -62,6 +84,9 @@ public:
   const Lagrange1D basis1D_;
   unsigned numNodes1D_;
   const unsigned dimension_;
+
+private:
+  std::vector<unsigned> nodeIndices_;  // indicesMap_ flattened, (node, dim)
 };
 
 
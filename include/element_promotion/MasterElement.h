@@ -24,6 +24,15 @@ enum Direction
   };
   }
 
+class ScratchWorkspace;
+
+/*
+ * Master elements are immutable once constructed: all of the member functions are const and
+ * write only to the caller's arrays, so one instance can be shared between threads.  Temporaries
+ * too large for the stack are taken from the workspace passed to determinant, grad_op and
+ * face_grad_op, which must belong to the calling thread.  Without a workspace, a temporary
+ * one is used for the call
+ */
 class MasterElement
 {
 public:
@@ -35,7 +44,8 @@ public:
     const int nelem,
     const double *coords,
     double *volume,
-    double * error ) {
+    double * error,
+    ScratchWorkspace* work = nullptr) const {
     throw std::runtime_error("determinant not implemented");}
 
   virtual void grad_op(
@@ -44,7 +54,8 @@ public:
     double *gradop,
     double *deriv,
     double *det_j,
-    double * error ) {
+    double * error,
+    ScratchWorkspace* work = nullptr) const {
     throw std::runtime_error("grad_op not implemented");}
 
   virtual void shifted_grad_op(
@@ -53,20 +64,20 @@ public:
     double *gradop,
     double *deriv,
     double *det_j,
-    double * error ) {
+    double * error ) const {
     throw std::runtime_error("grad_op not implemented");}
 
   virtual void gij(
     const double *coords,
     double *gupperij,
     double *glowerij,
-    double *deriv) {
+    double *deriv) const {
     throw std::runtime_error("gij not implemented");}
 
   virtual void nodal_grad_op(
     const int nelem,
     double *deriv,
-    double * error ) {
+    double * error ) const {
     throw std::runtime_error("nodal_grad_op not implemented");}
 
   virtual void face_grad_op(
@@ -75,38 +86,39 @@ public:
     const double *coords,
     double *gradop,
     double *det_j,
-    double * error ) {
+    double * error,
+    ScratchWorkspace* work = nullptr) const {
     throw std::runtime_error("face_grad_op not implemented; avoid this element type at open bcs, walls and symms");}
 
-  virtual const int * adjacentNodes() {
+  virtual const int * adjacentNodes() const {
     throw std::runtime_error("adjacentNodes not implementedunknown bc");
     return NULL;}
 
-  virtual const int * ipNodeMap(int ordinal = 0) {
+  virtual const int * ipNodeMap(int ordinal = 0) const {
     throw std::runtime_error("ipNodeMap not implemented");
     return NULL;}
 
   virtual void shape_fcn(
-    double *shpfc) {
+    double *shpfc) const {
     throw std::runtime_error("shape_fcn not implemented"); }
 
   virtual void shifted_shape_fcn(
-    double *shpfc) {
+    double *shpfc) const {
     throw std::runtime_error("shifted_shape_fcn not implemented"); }
 
   virtual int opposingNodes(
-    const int ordinal, const int node) {
+    const int ordinal, const int node) const {
     throw std::runtime_error("adjacentNodes not implemented"); }
 
   virtual int opposingFace(
-    const int ordinal, const int node) {
+    const int ordinal, const int node) const {
     throw std::runtime_error("opposingFace not implemented");
     return 0; }
 
   virtual double isInElement(
     const double *elemNodalCoord,
     const double *pointCoord,
-    double *isoParCoord) {
+    double *isoParCoord) const {
     throw std::runtime_error("isInElement not implemented");
     return 1.0e6; }
 
@@ -114,13 +126,13 @@ public:
     const int &nComp,
     const double *isoParCoord,
     const double *field,
-    double *result) {
+    double *result) const {
     throw std::runtime_error("interpolatePoint not implemented"); }
 
   virtual void general_shape_fcn(
     const int numIp,
     const double *isoParCoord,
-    double *shpfc) {
+    double *shpfc) const {
     throw std::runtime_error("general_shape_fcn not implement"); }
 
   virtual void general_face_grad_op(
@@ -129,29 +141,29 @@ public:
     const double *coords,
     double *gradop,
     double *det_j,
-    double * error ) {
+    double * error ) const {
     throw std::runtime_error("general_face_grad_op not implemented");}
 
   virtual void sidePcoords_to_elemPcoords(
     const int & side_ordinal,
     const int & npoints,
     const double *side_pcoords,
-    double *elem_pcoords) {
+    double *elem_pcoords) const {
     throw std::runtime_error("sidePcoords_to_elemPcoords");}
 
-  virtual const int * faceNodeOnExtrudedElem() {
+  virtual const int * faceNodeOnExtrudedElem() const {
     throw std::runtime_error("faceNodeOnExtrudedElem not implement"); }
 
-  virtual const int * opposingNodeOnExtrudedElem() {
+  virtual const int * opposingNodeOnExtrudedElem() const {
     throw std::runtime_error("opposingNodeOnExtrudedElem not implement"); }
 
-  virtual const int * faceScsIpOnExtrudedElem() {
+  virtual const int * faceScsIpOnExtrudedElem() const {
     throw std::runtime_error("faceScsIpOnExtrudedElem not implement"); }
 
-  virtual const int * faceScsIpOnFaceEdges() {
+  virtual const int * faceScsIpOnFaceEdges() const {
     throw std::runtime_error("faceScsIpOnFaceEdges not implement"); }
 
-  virtual const double * edgeAlignedArea() {
+  virtual const double * edgeAlignedArea() const {
     throw std::runtime_error("edgeAlignedArea not implement"); }
 
   double isoparametric_mapping(const double b, const double a, const double xi) const;
@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef MasterElementCache_h
+#define MasterElementCache_h
+
+#include <stddef.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace sierra {
+namespace naluUnit {
+
+  struct ElementDescription;
+  class MasterElement;
+
+  class MasterElementCache
+  {
+    /*
+     * Shares element descriptions and higher-order master elements between all of the users of
+     * an element type, keyed by (dimension, order, quadrature type, reduced geometric basis).
+     * Each type's tables are built once and are only read afterwards.  ElementDescription::create
+     * hands out the descriptions held here.
+     *
+     * The cache only observes what it hands out.  The returned pointers keep what they refer to
+     * alive, and a master element holds on to its element description, so an element type's
+     * tables are freed as soon as its last user lets go of them and are rebuilt if requested again
+     */
+  public:
+    static MasterElementCache& self();
+
+    std::shared_ptr<const ElementDescription> element_description(
+      int dimension,
+      int order,
+      std::string quadType = "GaussLegendre",
+      bool useReducedGeometricBasis = false
+    );
+
+    // master elements for elem's element type
+    std::shared_ptr<const MasterElement> volume_element(const ElementDescription& elem);
+    std::shared_ptr<const MasterElement> subcontrol_surface_element(const ElementDescription& elem);
+    std::shared_ptr<const MasterElement> boundary_element(const ElementDescription& elem);
+
+    // number of element types with a description still in use
+    size_t size() const;
+
+  private:
+    MasterElementCache() = default;
+
+    using Key = std::tuple<int, int, std::string, bool>;
+    struct Entry {
+      std::weak_ptr<const ElementDescription> elem;
+      std::weak_ptr<const MasterElement> volume;
+      std::weak_ptr<const MasterElement> surface;
+      std::weak_ptr<const MasterElement> boundary;
+    };
+
+    std::shared_ptr<const ElementDescription> description(const Key& key);
+    template <typename ME2D, typename ME3D>
+    std::shared_ptr<const MasterElement> master_element(
+      const ElementDescription& elem,
+      std::weak_ptr<const MasterElement> Entry::*cached
+    );
+    void erase_expired();
+    static Key key(const ElementDescription& elem);
+
+    mutable std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+  };
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
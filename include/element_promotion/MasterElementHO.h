@@ -8,6 +8,8 @@
 #define MasterElementHO_h
 
 #include <element_promotion/MasterElement.h>
+
+#include <stddef.h>
 #include <vector>
 #include <array>
 
@@ -19,8 +21,80 @@ namespace naluUnit{
     double weight;
   };
 
+  // batched gradient operator, gradop(ip, node, dim, elem).  The SCS master elements pick one
+  // with the node counts fixed at compile time for p = 1..8, and a generic one otherwise
+  using GradOpKernel = void (*)(
+    int nelem,
+    int numIntPoints,
+    int nodesPerElement,
+    int geometricNodesPerElement,
+    const double* geometricShapeDerivs,
+    const double* shapeDerivs,
+    const double* coords,
+    double* gradop,
+    double* det_j,
+    double* error,
+    double* deriv);
+
+  /*
+   * The volume and surface master elements (HigherOrderHexSCV/SCS, HigherOrderQuad2DSCV/SCS)
+   * evaluate nelem elements per call.  For nelem > 1 the element is the fastest-varying index
+   * of the coordinates, coords(node, dim, elem), and of the outputs, e.g. gradop(ip, node, dim, elem)
+   * and det_j(ip, elem), so the Jacobian math vectorizes across elements.  For nelem = 1 this is
+   * the usual single-element layout
+   */
+
 // 2D Quad 16 subcontrol volume
 struct ElementDescription;
+class LagrangeBasis;
+
+/*
+ * Locates physical points in a promoted quad or hex by a Newton iteration on the
+ * tensor-product geometry.  Points outside of the padded bounding box of the element's
+ * nodes are rejected without iterating, and the initial guess is taken from the linear
+ * sub-element closest to the point.  The iteration is batched over the points, with the
+ * point as the fastest-varying index, so locating many points in one element vectorizes
+ */
+class HigherOrderPointLocator
+{
+public:
+  explicit HigherOrderPointLocator(const ElementDescription& elem);
+
+  // elemNodalCoords(node, dim), pointCoords(point, dim) and isoParCoords(point, dim).
+  // The parametric distance of a point, max_d |isoParCoord_d|, is at most one inside
+  // the element, and is far_distance() for points that could not be located
+  void locate_points(
+    int numPoints,
+    const double* elemNodalCoords,
+    const double* pointCoords,
+    double* isoParCoords,
+    double* distances) const;
+
+  // field(comp, node) and result(point, comp)
+  void interpolate_points(
+    int numPoints,
+    int nComp,
+    const double* isoParCoords,
+    const double* field,
+    double* result) const;
+
+  static constexpr double far_distance() { return 1.0e6; }
+
+private:
+  void initial_guess(
+    const double* elemNodalCoords,
+    const double* centroids,
+    const double* pointCoord,
+    double* isoParCoord) const;
+
+  int dim_;
+  int nodes1D_;
+  int nodesPerElement_;
+  std::vector<double> nodeLocs_;
+  std::vector<double> lagrangeWeights_;
+  std::vector<int> nodeMap_;                // tensor-product index to node ordinal
+  std::vector<int> subElementNodes_;        // (subElement, corner), as in subElementConnectivity
+};
 
 class HigherOrderHexSCV : public MasterElement
 {
@@ -28,16 +102,29 @@ public:
   HigherOrderHexSCV(const ElementDescription& elem);
   virtual ~HigherOrderHexSCV() {}
 
-  void shape_fcn(double *shpfc) final;
-  const int * ipNodeMap(int ordinal = 0) final;
+  void shape_fcn(double *shpfc) const final;
+  const int * ipNodeMap(int ordinal = 0) const final;
 
   void determinant(
     const int nelem,
     const double *coords,
     double *volume,
-    double * error ) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
+
+  double isInElement(
+    const double *elemNodalCoord,
+    const double *pointCoord,
+    double *isoParCoord) const final;
+
+  void interpolatePoint(
+    const int &nComp,
+    const double *isoParCoord,
+    const double *field,
+    double *result) const final;
 
   const ElementDescription& elem_;
+  HigherOrderPointLocator pointLocator_;
   std::vector<double> ipWeight_;
   std::vector<double> shapeFunctions_;
   std::vector<double> shapeDerivs_;
@@ -46,26 +133,30 @@ public:
 
 private:
   void set_interior_info();
-
-  double jacobian_determinant(
-    const double *elemNodalCoords,
-    const double *shapeDerivs ) const;
 };
 
 // 3D Hex 27 subcontrol surface
 class HigherOrderHexSCS : public MasterElement
 {
 public:
-  HigherOrderHexSCS(const ElementDescription& elem);
+  // with useSumFactorization, grad_op, face_grad_op and determinant are evaluated from 1D
+  // Lagrange tables by sum factorization, and the dense shape derivative tables are not stored.
+  // The Jacobians on the tensor-product grids are then held in the scratch workspace.
+  // Otherwise, useFixedOrderKernels selects gradient kernels specialized on the polynomial order
+  HigherOrderHexSCS(
+    const ElementDescription& elem,
+    bool useSumFactorization = false,
+    bool useFixedOrderKernels = true);
   virtual ~HigherOrderHexSCS() {}
 
-  void shape_fcn(double *shpfc) final;
+  void shape_fcn(double *shpfc) const final;
 
   void determinant(
     const int nelem,
     const double *coords,
     double *areav,
-    double * error) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void grad_op(
     const int nelem,
@@ -73,7 +164,8 @@ public:
     double *gradop,
     double *deriv,
     double *det_j,
-    double * error) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void face_grad_op(
     const int nelem,
@@ -81,25 +173,38 @@ public:
     const double *coords,
     double *gradop,
     double *det_j,
-    double * error) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void gij(
     const double *coords,
     double *gupperij,
     double *glowerij,
-    double *deriv) final;
+    double *deriv) const final;
 
-  const int * adjacentNodes() final;
+  const int * adjacentNodes() const final;
 
-  const int * ipNodeMap(int ordinal = 0) final;
+  const int * ipNodeMap(int ordinal = 0) const final;
 
   int opposingNodes(
-    const int ordinal, const int node) final;
+    const int ordinal, const int node) const final;
 
   int opposingFace(
-    const int ordinal, const int node) final;
+    const int ordinal, const int node) const final;
+
+  double isInElement(
+    const double *elemNodalCoord,
+    const double *pointCoord,
+    double *isoParCoord) const final;
+
+  void interpolatePoint(
+    const int &nComp,
+    const double *isoParCoord,
+    const double *field,
+    double *result) const final;
 
   const ElementDescription& elem_;
+  HigherOrderPointLocator pointLocator_;
   std::vector<double> shapeFunctions_;
   std::vector<double> shapeDerivs_;
   std::vector<double> expFaceShapeDerivs_;
@@ -110,27 +215,59 @@ private:
   void set_interior_info();
   void set_boundary_info();
 
-  void area_vector(
+  void area_components(
     const Jacobian::Direction direction,
-    const double *elemNodalCoords,
-    double *shapeDeriv,
-    std::array<double, 3>& areaVector ) const;
-
-  void gradient(
-    const double* elemNodalCoords,
-    const double* shapeDeriv,
-    double* grad,
-    double* det_j ) const;
+    int& s1Component,
+    int& s2Component) const;
+
+  // a set of ips lying on a tensor-product grid of 1D points, e.g. all of the
+  // scs ips of one direction or the ips of one face
+  struct TensorGrid {
+    int firstIp;
+    int numPoints[3];
+    std::vector<int> gridIndex;          // grid point of each ip, s fastest
+    bool useGeometricBasis;              // basis used for the Jacobian
+    int nodes1D;
+    std::vector<double> interp[3];       // (point, node) 1D tables for the Jacobian
+    std::vector<double> deriv[3];
+    std::vector<double> shapeInterp[3];  // (point, node) 1D tables of the full basis
+    std::vector<double> shapeDeriv[3];
+  };
 
-  void gradient(
-    const double* elemNodalCoords,
-    const double* geometricShapeDeriv,
-    const double* shapeDeriv,
-    double* grad,
-    double* det_j ) const;
+  void set_tensor_grids();
+  TensorGrid make_tensor_grid(
+    const std::vector<double>& locs,
+    int firstIp,
+    int numIps,
+    const LagrangeBasis& basis) const;
+  void tensor_jacobian(
+    const TensorGrid& grid,
+    int nelem,
+    const double* coords,
+    double* work,
+    double* jac) const;
+  void tensor_grad_op(
+    const TensorGrid& grid,
+    int nelem,
+    const double* jac,
+    double* gradop,
+    double* deriv,
+    double* det_j,
+    double* error) const;
 
   std::vector<ContourData> ipInfo_;
   int ipsPerFace_;
+
+  bool useSumFactorization_;
+  GradOpKernel gradOpKernel_;
+  GradOpKernel faceGradOpKernel_;
+  std::vector<TensorGrid> scsGrids_;
+  std::vector<TensorGrid> faceGrids_;
+  std::vector<int> geometricNodeMap_;  // tensor-product index to node ordinal
+  std::vector<int> nodeMap_;
+  std::vector<int> nodeOrdinals_;      // node ordinal to tensor-product indices
+  size_t tensorWorkSize_;               // scratch for the Jacobian kernel
+  size_t tensorJacobianSize_;           // Jacobians on the largest grid, per element
 };
 
 // 3D Quad 9
@@ -140,15 +277,16 @@ public:
   HigherOrderQuad3DSCS(const ElementDescription& elem);
   virtual ~HigherOrderQuad3DSCS() {}
 
-  void shape_fcn(double *shpfc) final;
+  void shape_fcn(double *shpfc) const final;
 
-  const int * ipNodeMap(int ordinal = 0);
+  const int * ipNodeMap(int ordinal = 0) const final;
 
   void determinant(
     const int nelem,
     const double *coords,
     double *areav,
-    double * error );
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   const ElementDescription& elem_;
   std::vector<double> shapeFunctions_;
@@ -186,20 +324,33 @@ public:
   explicit HigherOrderQuad2DSCV(const ElementDescription& elem);
   virtual ~HigherOrderQuad2DSCV() {}
 
-  void shape_fcn(double *shpfc) final;
+  void shape_fcn(double *shpfc) const final;
 
-  const int * ipNodeMap(int ordinal = 0) final;
+  const int * ipNodeMap(int ordinal = 0) const final;
 
   void determinant(
     const int nelem,
     const double *coords,
     double *volume,
-    double * error ) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
-  const std::vector<double>& shape_functions() { return shapeFunctions_; };
-  const std::vector<double>& shape_derivs() { return shapeDerivs_; };
+  const std::vector<double>& shape_functions() const { return shapeFunctions_; };
+  const std::vector<double>& shape_derivs() const { return shapeDerivs_; };
+
+  double isInElement(
+    const double *elemNodalCoord,
+    const double *pointCoord,
+    double *isoParCoord) const final;
+
+  void interpolatePoint(
+    const int &nComp,
+    const double *isoParCoord,
+    const double *field,
+    double *result) const final;
 
   const ElementDescription& elem_;
+  HigherOrderPointLocator pointLocator_;
   std::vector<double> ipWeight_;
   std::vector<double> shapeFunctions_;
   std::vector<double> shapeDerivs_;
@@ -207,24 +358,22 @@ public:
   int geometricNodesPerElement_;
 private:
   void set_interior_info();
-
-  double jacobian_determinant(
-    const double *elemNodalCoords,
-    const double *shapeDerivs ) const;
 };
 class HigherOrderQuad2DSCS : public MasterElement
 {
 public:
-  explicit HigherOrderQuad2DSCS(const ElementDescription& elem);
+  // useFixedOrderKernels selects gradient kernels specialized on the polynomial order
+  explicit HigherOrderQuad2DSCS(const ElementDescription& elem, bool useFixedOrderKernels = true);
   virtual ~HigherOrderQuad2DSCS() {}
 
-  void shape_fcn(double *shpfc) final;
+  void shape_fcn(double *shpfc) const final;
 
   void determinant(
     const int nelem,
     const double *coords,
     double *areav,
-    double * error) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void grad_op(
     const int nelem,
@@ -232,7 +381,8 @@ public:
     double *gradop,
     double *deriv,
     double *det_j,
-    double * error) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void face_grad_op(
     const int nelem,
@@ -240,25 +390,38 @@ public:
     const double *coords,
     double *gradop,
     double *det_j,
-    double * error) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void gij(
     const double *coords,
     double *gupperij,
     double *glowerij,
-    double *deriv) final;
+    double *deriv) const final;
 
-  const int * adjacentNodes() final;
+  const int * adjacentNodes() const final;
 
-  const int * ipNodeMap(int ordinal = 0) final;
+  const int * ipNodeMap(int ordinal = 0) const final;
 
   int opposingNodes(
-    const int ordinal, const int node) final;
+    const int ordinal, const int node) const final;
 
   int opposingFace(
-    const int ordinal, const int node) final;
+    const int ordinal, const int node) const final;
+
+  double isInElement(
+    const double *elemNodalCoord,
+    const double *pointCoord,
+    double *isoParCoord) const final;
+
+  void interpolatePoint(
+    const int &nComp,
+    const double *isoParCoord,
+    const double *field,
+    double *result) const final;
 
   const ElementDescription& elem_;
+  HigherOrderPointLocator pointLocator_;
   std::vector<double> ipWeight_;
   std::vector<double> shapeFunctions_;
   std::vector<double> shapeDerivs_;
@@ -268,28 +431,13 @@ private:
   void set_interior_info();
   void set_boundary_info();
 
-  void area_vector(
-    const Jacobian::Direction direction,
-    const double* elemNodalCoords,
-    const double* shapeDeriv,
-    std::array<double,2>& areaVector) const;
-
-  void gradient(
-    const double* elemNodalCoords,
-    const double* shapeDeriv,
-    double* grad,
-    double* det_j) const;
-
-  void gradient(
-    const double* elemNodalCoords,
-    const double* geometricShapeDeriv,
-    const double* shapeDeriv,
-    double* grad,
-    double* det_j ) const;
+  int area_component(const Jacobian::Direction direction) const;
 
   std::vector<ContourData> ipInfo_;
   int ipsPerFace_;
   std::vector<double> expFaceShapeDerivs_;
+  GradOpKernel gradOpKernel_;
+  GradOpKernel faceGradOpKernel_;
 };
 
 class HigherOrderEdge2DSCS : public MasterElement
@@ -298,16 +446,17 @@ public:
   explicit HigherOrderEdge2DSCS(const ElementDescription& elem);
   virtual ~HigherOrderEdge2DSCS() {}
 
-  const int * ipNodeMap(int ordinal = 0) final;
+  const int * ipNodeMap(int ordinal = 0) const final;
 
   void determinant(
     const int nelem,
     const double *coords,
     double *areav,
-    double * error ) final;
+    double * error,
+    ScratchWorkspace* work = nullptr) const final;
 
   void shape_fcn(
-    double *shpfc) final;
+    double *shpfc) const final;
 
   std::vector<double> shapeFunctions_;
 private:
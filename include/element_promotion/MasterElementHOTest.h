@@ -35,6 +35,22 @@ public:
   bool check_volume_quadrature_quad_SGL(unsigned runs, double tol);
   bool check_volume_quadrature_hex(unsigned runs, double tol);
   bool check_volume_quadrature_hex_SGL(unsigned runs, double tol);
+  bool check_batched_evaluation(unsigned numElements, double tol);
+  bool check_sum_factorization(unsigned numElements, double tol);
+  bool check_master_element_cache();
+  bool check_element_description();
+  bool check_point_location(unsigned numPoints, double tol);
+  bool check_threaded_evaluation(unsigned numElements, int numThreads);
+  bool check_fixed_order_kernels(unsigned numElements, double tol);
+  bool check_basis_storage(unsigned numIps);
+  void benchmark_grad_op();
+  std::vector<double> perturbed_element_coords(unsigned numElements, bool perturb = true);
+  void reference_jacobians(
+    const LagrangeBasis& basis,
+    const std::vector<double>& locs,
+    const double* elemCoord,
+    std::vector<double>& cofactor,
+    std::vector<double>& detj);
   double poly_val(std::vector<double> coeffs, double x);
   double poly_int(std::vector<double> coeffs, double xlower, double xupper);
   double poly_der(std::vector<double> coeffs, double x);
@@ -42,7 +58,7 @@ public:
   unsigned nDim_;
   unsigned polyOrder_;
   bool outputTiming_;
-  std::unique_ptr<ElementDescription> elem_;
+  std::shared_ptr<const ElementDescription> elem_;
 };
 
 } // namespace naluUnit
@@ -25,7 +25,6 @@
 #include <iosfwd>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -46,7 +45,14 @@ namespace naluUnit {
 class PromoteElement
 {
 public:
-  explicit PromoteElement(ElementDescription& elemDescription);
+  // the child node requests are generated on numThreads threads.  With deterministicIds, the
+  // new nodes are numbered from their parent ids and the owning rank, and the super elements
+  // and faces from the ids of the base elements and faces they copy, all starting at
+  // deterministicIdOffset, instead of through the collective BulkData::generate_new_ids
+  explicit PromoteElement(
+    const ElementDescription& elemDescription,
+    int numThreads = 1,
+    bool deterministicIds = false);
   ~PromoteElement() {};
 
   void promote_elements(
@@ -72,60 +78,141 @@ public:
     return nodeElemMap_.at(node).size();
   }
 
+  // the deterministic ids leave the ids below the offset to the base mesh
+  static constexpr stk::mesh::EntityId deterministicIdOffset = 1ull << 32;
+
+  // number of distinct sets of parent nodes that the selected elements would add nodes to.
+  // Only generates the requests: the mesh is not modified
+  size_t num_child_node_requests(
+    const stk::mesh::BulkData& mesh,
+    const stk::mesh::Selector& selector) const;
+
+  // whether other generates the same child node requests for the selected elements, in the
+  // same order and each with the same parent ids, unsorted parent ids, number of children
+  // and shared elements in the same order.  Only generates the requests: the mesh is not modified
+  bool same_child_node_requests(
+    const PromoteElement& other,
+    const stk::mesh::BulkData& mesh,
+    const stk::mesh::Selector& selector) const;
+
 private:
-  class ChildNodeRequest
+  class ChildNodeRequestTable
   {
+    /*
+     * The requests for new nodes, one for each distinct set of parent nodes (an edge, face
+     * or volume of the base mesh), numbered in the order the selected elements first ask
+     * for them.  Stored as a struct of arrays: the parent ids are fixed-width keys and the
+     * children, shared elements, reordered child ordinals and sharing procs of request r
+     * are ranges of flat arrays given by the r-th offsets.  The table therefore holds a
+     * fixed number of allocations however large the mesh is, all released with the table
+     */
   public:
-    explicit ChildNodeRequest(std::vector<stk::mesh::EntityId>  in_parentIds);
-    ~ChildNodeRequest() = default;
-
-    bool operator==(const ChildNodeRequest& other) const
+    static constexpr unsigned maxParents = 8;
+    using ParentIds = std::array<stk::mesh::EntityId, maxParents>;
+    static constexpr size_t invalid_request = static_cast<size_t>(-1);
+
+    size_t size() const { return numParents_.size(); }
+    size_t total_num_children() const { return childOffsets_.back(); }
+
+    // whether the tables hold the same requests in the same order, with the same parent ids,
+    // unsorted parent ids, number of children and shared elements and relations in order
+    bool same_requests(const ChildNodeRequestTable& other) const;
+
+    // returns invalid_request if no request has the sorted parent ids
+    size_t find(const stk::mesh::EntityId* sortedParentIds, unsigned numParents) const;
+
+    // appends a request for parent ids not already in the table and returns its index
+    size_t add_request(
+      const stk::mesh::EntityId* sortedParentIds,
+      const stk::mesh::EntityId* unsortedParentIds,
+      unsigned numParents,
+      unsigned numChildren);
+
+    // record j is the j-th (element, added connectivity) pair of the element loop, which
+    // asked for request requestForRecord[j].  Lays out the per-element and per-child arrays
+    void set_shared_elems(
+      const std::vector<stk::mesh::Entity>& elems,
+      size_t numRelations,
+      const std::vector<size_t>& requestForRecord);
+
+    unsigned num_parents(size_t r) const { return numParents_[r]; }
+    const stk::mesh::EntityId* parent_ids(size_t r) const { return parentIds_[r].data(); }
+    const stk::mesh::EntityId* unsorted_parent_ids(size_t r) const { return unsortedParentIds_[r].data(); }
+
+    size_t num_children(size_t r) const { return childOffsets_[r + 1] - childOffsets_[r]; }
+    const stk::mesh::Entity* children(size_t r) const { return &children_[childOffsets_[r]]; }
+    const stk::mesh::EntityId* child_ids(size_t r) const { return &childIds_[childOffsets_[r]]; }
+
+    size_t num_shared_elems(size_t r) const { return sharedElemOffsets_[r + 1] - sharedElemOffsets_[r]; }
+    const stk::mesh::Entity* shared_elems(size_t r) const { return &sharedElems_[sharedElemOffsets_[r]]; }
+
+    // the added connectivity of the element matching the request
+    size_t shared_elem_relation(size_t r, unsigned elemNumber) const
     {
-      return parentIds_ == other.parentIds_;
+      return sharedElemRelations_[sharedElemOffsets_[r] + elemNumber];
     }
-    void determine_sharing_procs(const stk::mesh::BulkData& mesh) const;
-    void set_node_entity_for_request(stk::mesh::BulkData& mesh) const;
-    void add_shared_elem(const stk::mesh::Entity& elem) const;
-
-    std::vector<size_t> determine_child_node_ordinals(
-      const stk::mesh::BulkData& mesh,
-      const ElementDescription& elemDesc,
-      unsigned elemNumber) const;
 
-    void set_num_children(size_t num) const
+    size_t* reordered_child_ordinals(size_t r, unsigned elemNumber)
     {
-      children_.resize(num);
-      procGIdPairsFromAllProcs_.resize(num);
+      return &reorderedChildOrdinals_[ordinalOffsets_[r] + elemNumber * num_children(r)];
+    }
+    const size_t* reordered_child_ordinals(size_t r, unsigned elemNumber) const
+    {
+      return &reorderedChildOrdinals_[ordinalOffsets_[r] + elemNumber * num_children(r)];
     }
 
-    size_t num_children() const { return children_.size(); }
-    size_t num_parents() const { return parentIds_.size(); }
+    // sets the sharing procs of every request to the procs that all of its parents have in common
+    void determine_sharing_procs(const stk::mesh::BulkData& mesh);
+    size_t num_sharing_procs(size_t r) const { return sharingProcOffsets_[r + 1] - sharingProcOffsets_[r]; }
+    const int* sharing_procs(size_t r) const { return &sharingProcs_[sharingProcOffsets_[r]]; }
 
-    void add_proc_id_pair(int proc_id, stk::mesh::EntityId id, int childNumber) const;
-    stk::mesh::EntityId suggested_node_id(int childNumber) const;
-    stk::mesh::EntityId get_id_for_child(int childNumber) const;
+    // ids this proc suggests for the children of every request, in request order
+    void add_local_ids(int proc, const stk::mesh::EntityId* ids);
 
-    std::vector<stk::mesh::EntityId> parentIds_; // invariant
-    mutable std::vector<stk::mesh::EntityId> unsortedParentIds_;
-    mutable std::vector<stk::mesh::Entity> children_;
-    mutable std::vector<std::vector<size_t>> childOrdinalsForElem_;
-    mutable std::vector<std::vector<size_t>> reorderedChildOrdinalsForElem_;
-    mutable std::vector<stk::mesh::Entity> sharedElems_;
-    mutable std::vector<int> sharingProcs_;
+    // ids suggested by another proc for the children of a request, the id for child
+    // childIndices[j] being ids[j].  The lowest ranked proc's ids are kept
+    void add_proc_ids(size_t r, int proc, const stk::mesh::EntityId* ids, const size_t* childIndices);
 
-    using IdProcPair = std::pair<int,stk::mesh::EntityId>;
-    mutable std::vector<std::vector<IdProcPair>> procGIdPairsFromAllProcs_;
-  };
+    // declares the child nodes and the node sharing with the procs that suggested ids
+    void declare_child_nodes(stk::mesh::BulkData& mesh);
 
-  struct RequestHash
-  {
-    std::size_t operator()(const ChildNodeRequest& request) const
+  private:
+    void rehash(size_t numSlots);
+    size_t hash(const stk::mesh::EntityId* sortedParentIds, unsigned numParents) const
     {
       // Order-sensitive hash function hash({1,2}) != hash({2,1})
-      return boost::hash_range(request.parentIds_.begin(), request.parentIds_.end());
+      return boost::hash_range(sortedParentIds, sortedParentIds + numParents);
     }
+
+    // per request
+    std::vector<unsigned char> numParents_;
+    std::vector<ParentIds> parentIds_;
+    std::vector<ParentIds> unsortedParentIds_;
+    std::vector<size_t> childOffsets_{0};
+    std::vector<size_t> sharedElemOffsets_;
+    std::vector<size_t> ordinalOffsets_;
+    std::vector<size_t> sharingProcOffsets_;
+    std::vector<int> idProcs_; // proc whose suggested ids the children get
+
+    // open addressing index from the parent ids to the request, 0 marks an empty slot
+    std::vector<size_t> slots_;
+
+    // per shared element
+    std::vector<stk::mesh::Entity> sharedElems_;
+    std::vector<unsigned> sharedElemRelations_;
+    std::vector<size_t> reorderedChildOrdinals_;
+
+    // per child
+    std::vector<stk::mesh::Entity> children_;
+    std::vector<stk::mesh::EntityId> childIds_;
+
+    // per sharing proc, whether the proc also has the request
+    std::vector<int> sharingProcs_;
+    std::vector<unsigned char> procHasRequest_;
   };
 
+  using NodeRequests = ChildNodeRequestTable;
+
   struct EntityVecIdHash
   {
     std::size_t operator()(const std::vector<stk::mesh::EntityId>& ids) const
@@ -135,9 +222,6 @@ private:
     }
   };
 
-
-  using NodeRequests = std::unordered_set<ChildNodeRequest, RequestHash>;
-
   using ElemRelationsMap =
       std::unordered_map< stk::mesh::Entity,
                           std::vector<stk::mesh::Entity> >;
@@ -152,7 +236,7 @@ private:
   reorder_ordinals(
      const std::vector<T>& ordinals,
      const std::vector<T>& unsortedOrdinals,
-     const std::vector<T>& canonicalOrdinals,
+     ArrayView<T> canonicalOrdinals,
      unsigned numParents1D,
      unsigned numAddedNodes1D
    ) const;
@@ -170,20 +254,33 @@ private:
     const stk::mesh::BulkData& mesh,
     VectorFieldType& coordinates,
     const stk::mesh::Entity* node_rels,
-    const std::vector<size_t>& childOrdinals,
-    const std::vector<stk::mesh::EntityId>& parentNodeIds,
-    const std::vector<std::vector<double>>& isoParCoords) const;
+    ArrayView<size_t> childOrdinals,
+    const stk::mesh::EntityId* parentNodeIds,
+    ArrayView<double> isoParCoords) const;
 
   template<unsigned embedding_dimension, unsigned dimension>
   void interpolate_coords(
-    const std::vector<double>& isoParCoord,
+    const double* isoParCoord,
     const std::array<double, embedding_dimension*ipow(2,dimension)>& parentCoords,
     double* interpolatedCoords
   ) const;
 
+  // ordinals within the element of the parent nodes, in the order of parentIds
+  std::vector<size_t> parent_ordinals_in_elem(
+    const stk::mesh::BulkData& mesh,
+    stk::mesh::Entity elem,
+    const stk::mesh::EntityId* parentIds,
+    unsigned numParents) const;
+
   NodeRequests create_child_node_requests(
     const ElementDescription& elemDescription,
-    stk::mesh::BulkData& mesh,
+    const stk::mesh::BulkData& mesh,
+    const stk::mesh::Selector& selector
+  ) const;
+
+  NodeRequests create_child_node_requests_threaded(
+    const ElementDescription& elemDescription,
+    const stk::mesh::BulkData& mesh,
     const stk::mesh::Selector& selector
   ) const;
 
@@ -192,6 +289,15 @@ private:
     const stk::mesh::BulkData& mesh,
     NodeRequests& requests) const;
 
+  std::vector<stk::mesh::EntityId> deterministic_node_ids(
+    const stk::mesh::BulkData& mesh,
+    const NodeRequests& requests) const;
+
+  // id of the super element or face that copies a base mesh element or face
+  stk::mesh::EntityId deterministic_copy_id(
+    const stk::mesh::BulkData& mesh,
+    stk::mesh::Entity baseEntity) const;
+
   void batch_create_child_nodes(
     const ElementDescription& elemDescription,
     stk::mesh::BulkData & mesh,
@@ -235,11 +341,11 @@ private:
     const stk::mesh::PartVector& baseParts,
     const stk::mesh::PartVector& promotedParts) const;
 
-  size_t count_requested_nodes(const NodeRequests& requests) const;
-
   const ElementDescription& elemDescription_;
   const unsigned nodesPerElement_;
   const unsigned dimension_;
+  const int numThreads_;
+  const bool deterministicIds_;
 
   //upward relations
   ElemRelationsMap nodeElemMap_;
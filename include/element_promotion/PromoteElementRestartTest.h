@@ -77,10 +77,10 @@ public:
   void compute_projected_nodal_gradient_interior(stk::mesh::Selector& selector);
   void compute_projected_nodal_gradient_boundary(stk::mesh::Selector& selector);
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   create_master_subcontrol_surface_element(const ElementDescription& elem);
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   create_master_boundary_element(const ElementDescription& elem);
 
   unsigned determine_polynomial_order_from_meta_data(const stk::mesh::MetaData& meta) const;
@@ -100,9 +100,9 @@ public:
   std::unique_ptr<stk::io::StkMeshIoBroker> ioBroker_;
 
   // New element classes
-  std::unique_ptr<ElementDescription> elem_;
-  std::unique_ptr<MasterElement> meSCS_;
-  std::unique_ptr<MasterElement> meBC_;
+  std::shared_ptr<const ElementDescription> elem_;
+  std::shared_ptr<const MasterElement> meSCS_;
+  std::shared_ptr<const MasterElement> meBC_;
   std::unique_ptr<PromoteElement> promoteElement_;
   std::unique_ptr<PromotedElementIO> promoteIO_;
 
@@ -66,12 +66,21 @@ public:
     int dimension,
     int order,
     std::string meshName,
-    std::string quadType = "GaussLegendre"
+    std::string quadType = "GaussLegendre",
+    int numThreads = 1
   );
   ~PromoteElementTest();
 
   void execute();
 
+  // times the child node request generation on the unpromoted mesh for an increasing thread count
+  void benchmark_child_node_requests();
+
+  // times the promotion of the mesh and reports the growth of the resident memory during
+  // the promotion (peak) and after it (retained).  Only uses the public interface of
+  // PromoteElement, so that builds of other revisions can be compared on the same mesh
+  void benchmark_promotion(bool deterministicIds = false);
+
   void setup_mesh();
 
   double timing_wall(double timeA, double timeB);
@@ -94,13 +103,13 @@ public:
 
   void dump_coords();
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   create_master_volume_element(const ElementDescription& elem);
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   create_master_subcontrol_surface_element(const ElementDescription& elem);
 
-  std::unique_ptr<MasterElement>
+  std::shared_ptr<const MasterElement>
   create_master_boundary_element(const ElementDescription& elem);
 
   void compute_dual_nodal_volume_interior(
@@ -129,6 +138,8 @@ public:
   bool check_dual_nodal_volume_quad();
   bool check_dual_nodal_volume_hex();
   bool check_projected_nodal_gradient();
+  bool check_threaded_requests();
+  bool check_threaded_fields();
 
   const bool activateAura_;
   const double currentTime_;
@@ -145,6 +156,10 @@ public:
   bool outputTiming_;
   std::string quadType_;
 
+  // threads generating the child node requests and evaluating the master elements in the
+  // dual volume and projected gradient loops
+  int numThreads_;
+
   std::string elemType_;
   std::string coarseOutputName_;
   std::string fineOutputName_;
@@ -159,11 +174,11 @@ public:
 
   // New element classes
   std::unique_ptr<PromoteElement> promoteElement_;
-  std::unique_ptr<ElementDescription> elem_;
+  std::shared_ptr<const ElementDescription> elem_;
   std::unique_ptr<PromotedElementIO> promoteIO_;
-  std::unique_ptr<MasterElement> meSCV_;
-  std::unique_ptr<MasterElement> meSCS_;
-  std::unique_ptr<MasterElement> meBC_;
+  std::shared_ptr<const MasterElement> meSCV_;
+  std::shared_ptr<const MasterElement> meSCS_;
+  std::shared_ptr<const MasterElement> meBC_;
 
   // fields
   VectorFieldType* coordinates_;
@@ -12,14 +12,22 @@
 namespace sierra{
 namespace naluUnit{
 
-  // <abscissae, weights>
+  // <abscissae, weights>.  Rules with up to QuadratureTables::maxTabulatedPoints points
+  // come from precomputed tables, and are only computed for more points
   std::pair<std::vector<double>, std::vector<double>>
   gauss_legendre_rule(int order);
 
-  // <abscissae, weights>
+  // <abscissae, weights>, tabulated for the interval (-1, 1) as for gauss_legendre_rule
   std::pair<std::vector<double>, std::vector<double>>
   gauss_lobatto_legendre_rule(int order, double xleft = -1.0, double xright = +1.0);
 
+  // <abscissae, weights> from the Golub-Welsch algorithm, for any number of points
+  std::pair<std::vector<double>, std::vector<double>>
+  computed_gauss_legendre_rule(int order);
+
+  std::pair<std::vector<double>, std::vector<double>>
+  computed_gauss_lobatto_legendre_rule(int order, double xleft = -1.0, double xright = +1.0);
+
   // <abscissae, weights>
   std::pair<std::vector<double>, std::vector<double>>
   SGL_quadrature_rule(int order, std::vector<double> scsEndLocations);
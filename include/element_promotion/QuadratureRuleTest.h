@@ -25,6 +25,7 @@ public:
   void execute();
   bool check_lobatto();
   bool check_legendre();
+  bool check_tabulated_rules();
 };
 
 } // namespace naluUnit
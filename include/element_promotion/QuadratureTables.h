@@ -0,0 +1,32 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level Nalu          */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef QuadratureTables_h
+#define QuadratureTables_h
+
+namespace sierra{
+namespace naluUnit{
+namespace QuadratureTables {
+  /*
+   * Abscissae and weights of the Gauss-Legendre and Gauss-Lobatto-Legendre rules on [-1, 1],
+   * correctly rounded from 60-digit Newton iterations on the Legendre polynomials.  The
+   * abscissae are in ascending order and the rules are exactly symmetric.  The tables return
+   * nullptr for rules with more than maxTabulatedPoints points, or fewer than 1 (Gauss-Legendre)
+   * or 2 (Gauss-Lobatto-Legendre) points
+   */
+  constexpr int maxTabulatedPoints = 20;
+
+  const double* gauss_legendre_abscissae(int numPoints);
+  const double* gauss_legendre_weights(int numPoints);
+
+  const double* gauss_lobatto_legendre_abscissae(int numPoints);
+  const double* gauss_lobatto_legendre_weights(int numPoints);
+
+} // namespace QuadratureTables
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
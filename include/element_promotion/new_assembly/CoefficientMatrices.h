@@ -22,6 +22,7 @@ struct CoefficientMatrices
     scsInterp(HighOrderCoefficients::scs_interpolation_weights<poly_order>(nodeLocs, scsLocs)),
     nodalWeights(HighOrderCoefficients::nodal_integration_weights<poly_order>(nodeLocs, scsLocs)),
     nodalDeriv(HighOrderCoefficients::nodal_derivative_weights<poly_order>(nodeLocs)),
+    nodalWeightDeriv(HighOrderCoefficients::nodal_weight_derivative_products<poly_order>(nodalWeights, nodalDeriv)),
     linear_nodal_interp(HighOrderCoefficients::linear_nodal_interpolation_weights<poly_order>(nodeLocs)),
     linear_scs_interp(HighOrderCoefficients::linear_scs_interpolation_weights<poly_order>(scsLocs)) {};
 
@@ -30,6 +31,7 @@ struct CoefficientMatrices
     scsInterp(HighOrderCoefficients::scs_interpolation_weights<poly_order>()),
     nodalWeights(HighOrderCoefficients::nodal_integration_weights<poly_order>()),
     nodalDeriv(HighOrderCoefficients::nodal_derivative_weights<poly_order>()),
+    nodalWeightDeriv(HighOrderCoefficients::nodal_weight_derivative_products<poly_order>(nodalWeights, nodalDeriv)),
     linear_nodal_interp(HighOrderCoefficients::linear_nodal_interpolation_weights<poly_order>()),
     linear_scs_interp(HighOrderCoefficients::linear_scs_interpolation_weights<poly_order>()) {};
 
@@ -37,6 +39,7 @@ struct CoefficientMatrices
   const typename CoefficientViews<poly_order>::scs_matrix_array scsInterp;
   const typename CoefficientViews<poly_order>::nodal_matrix_array nodalWeights;
   const typename CoefficientViews<poly_order>::nodal_matrix_array nodalDeriv;
+  const typename CoefficientViews<poly_order>::nodal_matrix_product_array nodalWeightDeriv;
   const typename CoefficientViews<poly_order>::linear_nodal_matrix_array linear_nodal_interp;
   const typename CoefficientViews<poly_order>::linear_scs_matrix_array linear_scs_interp;
 };
@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef CoefficientMatrixRegistry_h
+#define CoefficientMatrixRegistry_h
+
+#include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <nalu_make_unique.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+template <unsigned p>
+class CoefficientMatrixRegistry
+{
+  /*
+   * Process-wide store of the coefficient matrices for polynomial order p.
+   * Each set of matrices is built once, on first request, and handed out by const reference
+   * for the rest of the run.  Safe to call from multiple threads
+   */
+public:
+  static const CoefficientMatrices<p>& get()
+  {
+    // Gauss-Lobatto nodes with Gauss-Legendre subcontrol surfaces.
+    // Initialization of a function-local static is thread-safe
+    static const CoefficientMatrices<p> matrices;
+    return matrices;
+  }
+
+  static const CoefficientMatrices<p>& get(const double* nodeLocs, const double* scsLocs)
+  {
+    // keyed on the node and scs locations
+    std::vector<double> key(nodeLocs, nodeLocs + p + 1);
+    key.insert(key.end(), scsLocs, scsLocs + p);
+
+    auto& registry = self();
+    std::lock_guard<std::mutex> guard(registry.mutex_);
+    auto it = registry.matrices_.find(key);
+    if (it == registry.matrices_.end()) {
+      it = registry.matrices_.emplace(
+        std::move(key),
+        make_unique<const CoefficientMatrices<p>>(nodeLocs, scsLocs)
+      ).first;
+    }
+    return *it->second;
+  }
+
+  static size_t size()
+  {
+    auto& registry = self();
+    std::lock_guard<std::mutex> guard(registry.mutex_);
+    return registry.matrices_.size();
+  }
+
+private:
+  CoefficientMatrixRegistry() = default;
+
+  static CoefficientMatrixRegistry& self()
+  {
+    static CoefficientMatrixRegistry registry;
+    return registry;
+  }
+
+  std::mutex mutex_;
+  std::map<std::vector<double>, std::unique_ptr<const CoefficientMatrices<p>>> matrices_;
+};
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
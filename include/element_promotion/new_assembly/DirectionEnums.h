@@ -0,0 +1,23 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef DirectionEnums_h
+#define DirectionEnums_h
+
+namespace sierra {
+namespace naluUnit {
+
+  // reference-element directions, shared between the quad and hex kernels
+  enum Direction {
+    XH = 0,
+    YH = 1,
+    ZH = 2
+  };
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
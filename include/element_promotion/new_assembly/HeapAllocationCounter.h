@@ -0,0 +1,26 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef HeapAllocationCounter_h
+#define HeapAllocationCounter_h
+
+#include <stddef.h>
+
+namespace sierra {
+namespace naluUnit {
+
+#ifdef NALU_COUNT_HEAP_ALLOCATIONS
+  // Number of calls to the global operator new made so far by any thread of the executable.
+  // The global operator new is replaced in the same translation unit, so that linking this in
+  // counts the containers, strings and managed Kokkos views (whose allocation records come from
+  // operator new) created anywhere in the run.  Only built with ENABLE_HEAP_ALLOCATION_COUNTER
+  size_t num_heap_allocations();
+#endif
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
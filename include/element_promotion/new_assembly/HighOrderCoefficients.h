@@ -125,6 +125,28 @@ nodal_derivative_weights(const double* nodeLocs)
 }
 //--------------------------------------------------------------------------
 template <unsigned poly_order>
+typename CoefficientViews<poly_order>::nodal_matrix_product_array
+nodal_weight_derivative_products(
+  const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalWeights,
+  const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv)
+{
+  // W(n,k) D(k,j), before the sum over k: the sum is taken against a metric term
+  // that depends on k, so only the product can be reused
+  constexpr unsigned nodes1D = poly_order + 1;
+  typename CoefficientViews<poly_order>::nodal_matrix_product_array
+  weightDeriv("nodal integration weights times nodal derivative");
+
+  for (unsigned n = 0; n < nodes1D; ++n) {
+    for (unsigned k = 0; k < nodes1D; ++k) {
+      for (unsigned j = 0; j < nodes1D; ++j) {
+        weightDeriv(n,k,j) = nodalWeights(n,k) * nodalDeriv(k,j);
+      }
+    }
+  }
+  return weightDeriv;
+}
+//--------------------------------------------------------------------------
+template <unsigned poly_order>
 typename QuadViews<poly_order>::nodal_scalar_array
 nodal_integration_weights()
 {
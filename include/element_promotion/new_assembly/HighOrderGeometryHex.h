@@ -0,0 +1,303 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef HighOrderGeometryHex_h
+#define HighOrderGeometryHex_h
+
+#include <element_promotion/new_assembly/HighOrderOperatorsHex.h>
+#include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <element_promotion/new_assembly/DirectionEnums.h>
+#include <TopologyViews.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sierra {
+namespace naluUnit {
+namespace HighOrderMetrics
+{
+  namespace HexInternal {
+    inline void diffusion_metric_row(int dir, const double jac[3][3], double* metric)
+    {
+      /*
+       * Row "dir" of the metric (A^T J^-1) for a single point given the Jacobian, jac(component, direction).
+       * The area vectors are the rows of the cofactor matrix of the Jacobian, so that
+       * metric(dir, e) = -(r_dir . r_e) / det(J).  The sign follows the quad kernels.
+       */
+      double r[3][3];
+      for (int d = 0; d < 3; ++d) {
+        const int d1 = (d + 1) % 3;
+        const int d2 = (d + 2) % 3;
+        r[d][0] = jac[1][d1] * jac[2][d2] - jac[2][d1] * jac[1][d2];
+        r[d][1] = jac[2][d1] * jac[0][d2] - jac[0][d1] * jac[2][d2];
+        r[d][2] = jac[0][d1] * jac[1][d2] - jac[1][d1] * jac[0][d2];
+      }
+      const double inv_detj = 1.0 / (jac[0][XH] * r[XH][0] + jac[1][XH] * r[XH][1] + jac[2][XH] * r[XH][2]);
+
+      for (int e = 0; e < 3; ++e) {
+        metric[e] = -inv_detj * (r[dir][0] * r[e][0] + r[dir][1] * r[e][1] + r[dir][2] * r[e][2]);
+      }
+    }
+    //--------------------------------------------------------------------------
+    inline double determinant(const double jac[3][3])
+    {
+      return (
+          jac[0][0] * (jac[1][1] * jac[2][2] - jac[1][2] * jac[2][1])
+        - jac[0][1] * (jac[1][0] * jac[2][2] - jac[1][2] * jac[2][0])
+        + jac[0][2] * (jac[1][0] * jac[2][1] - jac[1][1] * jac[2][0])
+      );
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void linear_edge_differences(
+      const typename HexViews<poly_order>::nodal_vector_array& coordinates,
+      double edge[3][3][2][2])
+    {
+      // differences of the vertex coordinates along each of the 12 edges of the hex,
+      // edge(direction, component, slow, fast) with (slow, fast) the vertex indices
+      // of the remaining two directions
+      constexpr int p = poly_order;
+      for (int d = 0; d < 3; ++d) {
+        for (int b = 0; b < 2; ++b) {
+          for (int a = 0; a < 2; ++a) {
+            edge[XH][d][b][a] = coordinates(d, b * p, a * p, p) - coordinates(d, b * p, a * p, 0);
+            edge[YH][d][b][a] = coordinates(d, b * p, p, a * p) - coordinates(d, b * p, 0, a * p);
+            edge[ZH][d][b][a] = coordinates(d, p, b * p, a * p) - coordinates(d, 0, b * p, a * p);
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    inline void linear_jacobian(
+      const double edge[3][3][2][2],
+      const double lx[2], const double ly[2], const double lz[2],
+      double jac[3][3])
+    {
+      // Jacobian of the trilinear map, jac(component, direction).  The factor of a half
+      // is from differentiating the linear interpolants on [-1,1]
+      for (int d = 0; d < 3; ++d) {
+        jac[d][XH] = 0.5 * (
+            lz[0] * (ly[0] * edge[XH][d][0][0] + ly[1] * edge[XH][d][0][1])
+          + lz[1] * (ly[0] * edge[XH][d][1][0] + ly[1] * edge[XH][d][1][1])
+        );
+        jac[d][YH] = 0.5 * (
+            lz[0] * (lx[0] * edge[YH][d][0][0] + lx[1] * edge[YH][d][0][1])
+          + lz[1] * (lx[0] * edge[YH][d][1][0] + lx[1] * edge[YH][d][1][1])
+        );
+        jac[d][ZH] = 0.5 * (
+            ly[0] * (lx[0] * edge[ZH][d][0][0] + lx[1] * edge[ZH][d][0][1])
+          + ly[1] * (lx[0] * edge[ZH][d][1][0] + lx[1] * edge[ZH][d][1][1])
+        );
+      }
+    }
+  }
+
+  template <unsigned poly_order>
+  void compute_diffusion_metric(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename HexViews<poly_order>::nodal_vector_array& coordinates,
+    typename HexViews<poly_order>::scs_tensor_array& metric,
+    ScratchWorkspace& work)
+  {
+    /*
+     * Metric for the full isoparametric mapping (supports curved elements)
+     * The metric is a combination of the inverse of the Jacobian and the area-vector (A^T J^-1),
+     * that arises when applying the divergence and gradient operators together
+     */
+    using TopoView = HexViews<poly_order>;
+
+    ScratchScope scope(work);
+    auto jac = work.get_view<typename TopoView::scs_tensor_array>();
+    double jac_ip[3][3];
+    double metric_ip[3];
+
+    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac, work);
+    for (unsigned s = 0; s < TopoView::poly_order; ++s) {
+      for (unsigned k = 0; k < TopoView::nodes1D; ++k) {
+        for (unsigned j = 0; j < TopoView::nodes1D; ++j) {
+          for (int c = 0; c < 3; ++c) {
+            for (int d = 0; d < 3; ++d) {
+              jac_ip[c][d] = jac(c, d, s, k, j);
+            }
+          }
+          HexInternal::diffusion_metric_row(XH, jac_ip, metric_ip);
+          for (int d = 0; d < 3; ++d) {
+            metric(XH, d, s, k, j) = metric_ip[d];
+          }
+        }
+      }
+    }
+
+    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac, work);
+    for (unsigned s = 0; s < TopoView::poly_order; ++s) {
+      for (unsigned k = 0; k < TopoView::nodes1D; ++k) {
+        for (unsigned i = 0; i < TopoView::nodes1D; ++i) {
+          for (int c = 0; c < 3; ++c) {
+            for (int d = 0; d < 3; ++d) {
+              jac_ip[c][d] = jac(c, d, s, k, i);
+            }
+          }
+          HexInternal::diffusion_metric_row(YH, jac_ip, metric_ip);
+          for (int d = 0; d < 3; ++d) {
+            metric(YH, d, s, k, i) = metric_ip[d];
+          }
+        }
+      }
+    }
+
+    HighOrderOperators::scs_zhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac, work);
+    for (unsigned s = 0; s < TopoView::poly_order; ++s) {
+      for (unsigned j = 0; j < TopoView::nodes1D; ++j) {
+        for (unsigned i = 0; i < TopoView::nodes1D; ++i) {
+          for (int c = 0; c < 3; ++c) {
+            for (int d = 0; d < 3; ++d) {
+              jac_ip[c][d] = jac(c, d, s, j, i);
+            }
+          }
+          HexInternal::diffusion_metric_row(ZH, jac_ip, metric_ip);
+          for (int d = 0; d < 3; ++d) {
+            metric(ZH, d, s, j, i) = metric_ip[d];
+          }
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void compute_volume_metric(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename HexViews<poly_order>::nodal_vector_array& coordinates,
+    typename HexViews<poly_order>::nodal_scalar_array& vol,
+    ScratchWorkspace& work)
+  {
+    // Computes det(J) at nodes using the full isoparametric formulation
+    ScratchScope scope(work);
+    auto jac = work.get_view<typename HexViews<poly_order>::nodal_tensor_array>();
+    HighOrderOperators::nodal_grad<poly_order>(mat.nodalDeriv, coordinates, jac);
+
+    double jac_ip[3][3];
+    for (unsigned k = 0; k < poly_order + 1; ++k) {
+      for (unsigned j = 0; j < poly_order + 1; ++j) {
+        for (unsigned i = 0; i < poly_order + 1; ++i) {
+          for (int c = 0; c < 3; ++c) {
+            for (int d = 0; d < 3; ++d) {
+              jac_ip[c][d] = jac(c, d, k, j, i);
+            }
+          }
+          vol(k, j, i) = HexInternal::determinant(jac_ip);
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void compute_diffusion_metric_linear(
+    const CoefficientMatrices<poly_order>& mats,
+    const typename HexViews<poly_order>::nodal_vector_array& coordinates,
+    typename HexViews<poly_order>::scs_tensor_array& metric)
+  {
+    /*
+     * Faster metric computation for geometrically linear elements
+     */
+    double edge[3][3][2][2];
+    HexInternal::linear_edge_differences<poly_order>(coordinates, edge);
+
+    double jac_ip[3][3];
+    double metric_ip[3];
+    for (unsigned s = 0; s < poly_order; ++s) {
+      const double ls[2] = { mats.linear_scs_interp(0, s), mats.linear_scs_interp(1, s) };
+      for (unsigned a = 0; a < poly_order + 1; ++a) {
+        const double la[2] = { mats.linear_nodal_interp(0, a), mats.linear_nodal_interp(1, a) };
+        for (unsigned b = 0; b < poly_order + 1; ++b) {
+          const double lb[2] = { mats.linear_nodal_interp(0, b), mats.linear_nodal_interp(1, b) };
+
+          // constant xhat surfaces, (s, k=a, j=b)
+          HexInternal::linear_jacobian(edge, ls, lb, la, jac_ip);
+          HexInternal::diffusion_metric_row(XH, jac_ip, metric_ip);
+          for (int d = 0; d < 3; ++d) {
+            metric(XH, d, s, a, b) = metric_ip[d];
+          }
+
+          // constant yhat surfaces, (s, k=a, i=b)
+          HexInternal::linear_jacobian(edge, lb, ls, la, jac_ip);
+          HexInternal::diffusion_metric_row(YH, jac_ip, metric_ip);
+          for (int d = 0; d < 3; ++d) {
+            metric(YH, d, s, a, b) = metric_ip[d];
+          }
+
+          // constant zhat surfaces, (s, j=a, i=b)
+          HexInternal::linear_jacobian(edge, lb, la, ls, jac_ip);
+          HexInternal::diffusion_metric_row(ZH, jac_ip, metric_ip);
+          for (int d = 0; d < 3; ++d) {
+            metric(ZH, d, s, a, b) = metric_ip[d];
+          }
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void compute_volume_metric_linear(
+    const CoefficientMatrices<poly_order>& mats,
+    const typename HexViews<poly_order>::nodal_vector_array& coordinates,
+    typename HexViews<poly_order>::nodal_scalar_array& vol)
+  {
+    // Computes det(J) at nodes using a linear basis for element geometry
+    double edge[3][3][2][2];
+    HexInternal::linear_edge_differences<poly_order>(coordinates, edge);
+
+    double jac_ip[3][3];
+    for (unsigned k = 0; k < poly_order + 1; ++k) {
+      const double lz[2] = { mats.linear_nodal_interp(0, k), mats.linear_nodal_interp(1, k) };
+      for (unsigned j = 0; j < poly_order + 1; ++j) {
+        const double ly[2] = { mats.linear_nodal_interp(0, j), mats.linear_nodal_interp(1, j) };
+        for (unsigned i = 0; i < poly_order + 1; ++i) {
+          const double lx[2] = { mats.linear_nodal_interp(0, i), mats.linear_nodal_interp(1, i) };
+          HexInternal::linear_jacobian(edge, lx, ly, lz, jac_ip);
+          vol(k, j, i) = HexInternal::determinant(jac_ip);
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  bool constant_diagonal_metric(
+    const typename HexViews<poly_order>::scs_tensor_array& metric,
+    double* axis_scales)
+  {
+    // Detects the diagonal, constant metric of an affine element with orthogonal edges
+    constexpr double tol = 1.0e-12;
+    double scale = 0.0;
+    for (int d = 0; d < 3; ++d) {
+      axis_scales[d] = metric(d,d,0,0,0);
+      scale = std::max(scale, std::abs(axis_scales[d]));
+    }
+    if (axis_scales[XH] * axis_scales[YH] <= 0.0 || axis_scales[XH] * axis_scales[ZH] <= 0.0) {
+      return false;
+    }
+
+    for (int d = 0; d < 3; ++d) {
+      for (int e = 0; e < 3; ++e) {
+        const double expected = (d == e) ? axis_scales[d] : 0.0;
+        for (unsigned k = 0; k < poly_order; ++k) {
+          for (unsigned j = 0; j < poly_order + 1; ++j) {
+            for (unsigned i = 0; i < poly_order + 1; ++i) {
+              if (std::abs(metric(d,e,k,j,i) - expected) > tol * scale) {
+                return false;
+              }
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+} // namespace HighOrderMetrics
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
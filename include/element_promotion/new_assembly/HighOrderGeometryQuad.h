@@ -9,22 +9,22 @@
 
 #include <element_promotion/new_assembly/HighOrderOperatorsQuad.h>
 #include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <element_promotion/new_assembly/DirectionEnums.h>
 #include <TopologyViews.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace sierra {
 namespace naluUnit {
 namespace HighOrderMetrics
 {
-  enum Direction {
-    XH = 0,
-    YH = 1
-  };
-
   template <unsigned poly_order>
   void compute_diffusion_metric(
     const CoefficientMatrices<poly_order>& mat,
     const typename QuadViews<poly_order>::nodal_vector_array& coordinates,
-    typename QuadViews<poly_order>::scs_tensor_array& metric)
+    typename QuadViews<poly_order>::scs_tensor_array& metric,
+    ScratchWorkspace& work)
   {
     /*
      * Metric for the full isoparametric mapping (supports curved elements)
@@ -34,8 +34,9 @@ namespace HighOrderMetrics
      */
     using TopoView = QuadViews<poly_order>;
 
-    typename TopoView::scs_tensor_array jac("jacobian");
-    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac);
+    ScratchScope scope(work);
+    auto jac = work.get_view<typename TopoView::scs_tensor_array>();
+    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac, work);
 
     for (unsigned j = 0; j < TopoView::poly_order; ++j) {
       for (unsigned i = 0; i < TopoView::nodes1D; ++i) {
@@ -46,7 +47,7 @@ namespace HighOrderMetrics
       }
     }
 
-    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac);
+    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, coordinates, jac, work);
 
     for (unsigned j = 0; j < TopoView::poly_order; ++j) {
       for (unsigned i = 0; i < TopoView::nodes1D; ++i) {
@@ -61,10 +62,12 @@ namespace HighOrderMetrics
   void compute_volume_metric(
     const CoefficientMatrices<poly_order>& mat,
     typename QuadViews<poly_order>::nodal_vector_array& coordinates,
-    typename QuadViews<poly_order>::nodal_scalar_array& vol)
+    typename QuadViews<poly_order>::nodal_scalar_array& vol,
+    ScratchWorkspace& work)
   {
     // Computes det(J) at nodes using the full isoparametric formulation
-    typename QuadViews<poly_order>::nodal_tensor_array jac("jacobian");
+    ScratchScope scope(work);
+    auto jac = work.get_view<typename QuadViews<poly_order>::nodal_tensor_array>();
     HighOrderOperators::nodal_grad<poly_order>(mat.nodalDeriv, coordinates, jac);
 
     for (unsigned j = 0; j <  poly_order+1; ++j) {
@@ -155,6 +158,140 @@ namespace HighOrderMetrics
       }
     }
   }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void compute_diffusion_metric_linear(
+    const CoefficientMatrices<poly_order>& mats,
+    const typename QuadBatchViews<poly_order>::nodal_vector_array& coordinates,
+    typename QuadBatchViews<poly_order>::scs_tensor_array& metric)
+  {
+    // compute_diffusion_metric_linear for a batch of elements, one per lane
+    constexpr int lanes = QuadBatchViews<poly_order>::lanes;
+
+    double dx_x0[lanes]; double dx_x1[lanes]; double dx_y0[lanes]; double dx_y1[lanes];
+    double dy_x0[lanes]; double dy_x1[lanes]; double dy_y0[lanes]; double dy_y1[lanes];
+    for (int l = 0; l < lanes; ++l) {
+      dx_x0[l] = coordinates(XH, poly_order, 0, l) - coordinates(XH, 0, 0, l);
+      dx_x1[l] = coordinates(XH, 0, poly_order, l) - coordinates(XH, 0, 0, l);
+      dx_y0[l] = coordinates(XH, poly_order, poly_order, l) - coordinates(XH, poly_order, 0, l);
+      dx_y1[l] = coordinates(XH, poly_order, poly_order, l) - coordinates(XH, 0, poly_order, l);
+
+      dy_x0[l] = coordinates(YH, poly_order, 0, l) - coordinates(YH, 0, 0, l);
+      dy_x1[l] = coordinates(YH, 0, poly_order, l) - coordinates(YH, 0, 0, l);
+      dy_y0[l] = coordinates(YH, poly_order, poly_order, l) - coordinates(YH, poly_order, 0, l);
+      dy_y1[l] = coordinates(YH, poly_order, poly_order, l) - coordinates(YH, 0, poly_order, l);
+    }
+
+    for (unsigned j = 0; j < poly_order; ++j) {
+      const double scs0 = mats.linear_scs_interp(0,j);
+      const double scs1 = mats.linear_scs_interp(1,j);
+      for (unsigned i = 0; i < poly_order+1; ++i) {
+        const double nodal0 = mats.linear_nodal_interp(0,i);
+        const double nodal1 = mats.linear_nodal_interp(1,i);
+        for (int l = 0; l < lanes; ++l) {
+          const double dx_dyh = scs0 * dx_x0[l] + scs1 * dx_y1[l];
+          const double dy_dyh = scs0 * dy_x0[l] + scs1 * dy_y1[l];
+          const double dx_dxh = nodal0 * dx_x1[l] + nodal1 * dx_y0[l];
+          const double dy_dxh = nodal0 * dy_x1[l] + nodal1 * dy_y0[l];
+
+          const double inv_detj = 1.0 / (dx_dyh * dy_dxh - dx_dxh * dy_dyh);
+          metric(XH,XH,j,i,l) =  inv_detj * (dx_dyh * dx_dyh + dy_dyh * dy_dyh);
+          metric(XH,YH,j,i,l) = -inv_detj * (dx_dxh * dx_dyh + dy_dxh * dy_dyh);
+        }
+      }
+    }
+
+    for (unsigned j = 0; j < poly_order; ++j) {
+      const double scs0 = mats.linear_scs_interp(0,j);
+      const double scs1 = mats.linear_scs_interp(1,j);
+      for (unsigned i = 0; i < poly_order+1; ++i) {
+        const double nodal0 = mats.linear_nodal_interp(0,i);
+        const double nodal1 = mats.linear_nodal_interp(1,i);
+        for (int l = 0; l < lanes; ++l) {
+          const double dx_dxh = scs0 * dx_x1[l] + scs1 * dx_y0[l];
+          const double dy_dxh = scs0 * dy_x1[l] + scs1 * dy_y0[l];
+          const double dx_dyh = nodal0 * dx_x0[l] + nodal1 * dx_y1[l];
+          const double dy_dyh = nodal0 * dy_x0[l] + nodal1 * dy_y1[l];
+
+          const double inv_detj = 1.0 / (dx_dyh * dy_dxh - dx_dxh * dy_dyh);
+          metric(YH,XH,j,i,l) = -inv_detj * (dx_dxh * dx_dyh + dy_dxh * dy_dyh);
+          metric(YH,YH,j,i,l) =  inv_detj * (dx_dxh * dx_dxh + dy_dxh * dy_dxh);
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void compute_volume_metric_linear(
+    const CoefficientMatrices<poly_order>& mats,
+    const typename QuadBatchViews<poly_order>::nodal_vector_array& coordinates,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& vol)
+  {
+    // compute_volume_metric_linear for a batch of elements, one per lane
+    constexpr int lanes = QuadBatchViews<poly_order>::lanes;
+
+    double dx_x0[lanes]; double dx_x1[lanes]; double dx_y0[lanes]; double dx_y1[lanes];
+    double dy_x0[lanes]; double dy_x1[lanes]; double dy_y0[lanes]; double dy_y1[lanes];
+    for (int l = 0; l < lanes; ++l) {
+      dx_x0[l] = coordinates(XH, poly_order, 0, l) - coordinates(XH, 0, 0, l);
+      dx_x1[l] = coordinates(XH, 0, poly_order, l) - coordinates(XH, 0, 0, l);
+      dx_y0[l] = coordinates(XH, poly_order, poly_order, l) - coordinates(XH, poly_order, 0, l);
+      dx_y1[l] = coordinates(XH, poly_order, poly_order, l) - coordinates(XH, 0, poly_order, l);
+
+      dy_x0[l] = coordinates(YH, poly_order, 0, l) - coordinates(YH, 0, 0, l);
+      dy_x1[l] = coordinates(YH, 0, poly_order, l) - coordinates(YH, 0, 0, l);
+      dy_y0[l] = coordinates(YH, poly_order, poly_order, l) - coordinates(YH, poly_order, 0, l);
+      dy_y1[l] = coordinates(YH, poly_order, poly_order, l) - coordinates(YH, 0, poly_order, l);
+    }
+
+    for (unsigned j = 0; j < poly_order + 1; ++j) {
+      const double nodal0_j = mats.linear_nodal_interp(0,j);
+      const double nodal1_j = mats.linear_nodal_interp(1,j);
+      for (unsigned i = 0; i < poly_order + 1; ++i) {
+        const double nodal0_i = mats.linear_nodal_interp(0,i);
+        const double nodal1_i = mats.linear_nodal_interp(1,i);
+        for (int l = 0; l < lanes; ++l) {
+          const double dx_dyh = nodal0_j * dx_x1[l] + nodal1_j * dx_y0[l];
+          const double dy_dyh = nodal0_j * dy_x1[l] + nodal1_j * dy_y0[l];
+          const double dx_dxh = nodal0_i * dx_x0[l] + nodal1_i * dx_y1[l];
+          const double dy_dxh = nodal0_i * dy_x0[l] + nodal1_i * dy_y1[l];
+
+          vol(j,i,l) = 0.25 * (dx_dyh * dy_dxh  - dx_dxh * dy_dyh);
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  bool constant_diagonal_metric(
+    const typename QuadViews<poly_order>::scs_tensor_array& metric,
+    double* axis_scales)
+  {
+    /*
+     * Detects the metric of an affine element with orthogonal edges: diagonal and constant
+     * over the subcontrol surfaces, so that the elemental Laplacian is a sum of Kronecker products
+     * of 1D operators scaled by axis_scales[d] = metric(d,d)
+     */
+    constexpr double tol = 1.0e-12;
+    axis_scales[XH] = metric(XH,XH,0,0);
+    axis_scales[YH] = metric(YH,YH,0,0);
+    const double scale = std::max(std::abs(axis_scales[XH]), std::abs(axis_scales[YH]));
+    if (axis_scales[XH] * axis_scales[YH] <= 0.0) {
+      return false;
+    }
+
+    for (unsigned j = 0; j < poly_order; ++j) {
+      for (unsigned i = 0; i < poly_order + 1; ++i) {
+        if (std::abs(metric(XH,XH,j,i) - axis_scales[XH]) > tol * scale
+            || std::abs(metric(YH,YH,j,i) - axis_scales[YH]) > tol * scale
+            || std::abs(metric(XH,YH,j,i)) > tol * scale
+            || std::abs(metric(YH,XH,j,i)) > tol * scale) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
 
 } // namespace HighOrderGeometryQuad
 } // namespace naluUnit
@@ -0,0 +1,351 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef HighOrderLaplacianHex_h
+#define HighOrderLaplacianHex_h
+
+#include <element_promotion/new_assembly/HighOrderOperatorsHex.h>
+#include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <element_promotion/new_assembly/DirectionEnums.h>
+#include <TopologyViews.h>
+
+namespace sierra {
+namespace naluUnit {
+namespace TensorAssembly {
+
+  template <unsigned nodes1D>
+  int idx(int k, int j, int i) { return (k*nodes1D+j)*nodes1D+i; };
+
+  template <unsigned poly_order>
+  void add_elemental_laplacian_matrix(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename HexViews<poly_order>::scs_tensor_array& metric,
+    typename HexViews<poly_order>::matrix_array& lhs)
+  {
+    /*
+     * Computes the elemental lhs for the Laplacian operator given
+     * the correct grid metrics.  The flux through each subcontrol surface is
+     * added to the node behind it and subtracted from the node in front of it.
+     *
+     * For the flux through the constant xhat surface "s" between the
+     * nodes (nk, nj, s) and (nk, nj, s+1), the derivative of node (k,j,i) is
+     *
+     *  W(nk,k) W(nj,j) M_xx(s,k,j) S(s,i)
+     *    + I(s,i) W(nk,k) sum_l WD(nj,l,j) M_xy(s,k,l)
+     *    + I(s,i) W(nj,j) sum_l WD(nk,l,k) M_xz(s,l,j)
+     *
+     * with W, D, I, S the nodal integration, nodal derivative, scs interpolation
+     * and scs derivative matrices and WD(n,l,j) = W(n,l) D(l,j).  The first sum does not depend on nk
+     * and the second does not depend on nj, so both are computed once per surface
+     * before the scatter.  The other two directions are the same with the indices permuted.
+     * The two sums are small enough, 2 (p+1)^3 doubles, to live on the stack.
+     */
+    using TopoView = HexViews<poly_order>;
+    constexpr int n1 = TopoView::nodes1D;
+
+    double non_orth_a_data[n1 * n1 * n1];
+    double non_orth_b_data[n1 * n1 * n1];
+    typename TopoView::nodal_scalar_array non_orth_a(non_orth_a_data);
+    typename TopoView::nodal_scalar_array non_orth_b(non_orth_b_data);
+
+    // flux past constant xhat surfaces
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int k = 0; k < n1; ++k) {
+        for (int n = 0; n < n1; ++n) {
+          for (int j = 0; j < n1; ++j) {
+            double sum_y = 0.0;
+            double sum_z = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum_y += mat.nodalWeightDeriv(n, l, j) * metric(XH, YH, s, k, l);
+              sum_z += mat.nodalWeightDeriv(n, l, k) * metric(XH, ZH, s, l, j);
+            }
+            non_orth_a(k, n, j) = sum_y;
+            non_orth_b(n, k, j) = sum_z;
+          }
+        }
+      }
+
+      for (int nk = 0; nk < n1; ++nk) {
+        for (int nj = 0; nj < n1; ++nj) {
+          const int row_minus = idx<n1>(nk, nj, s);
+          const int row_plus = idx<n1>(nk, nj, s + 1);
+          for (int k = 0; k < n1; ++k) {
+            for (int j = 0; j < n1; ++j) {
+              const double wk = mat.nodalWeights(nk, k);
+              const double wj = mat.nodalWeights(nj, j);
+              const double orth = wk * wj * metric(XH, XH, s, k, j);
+              const double non_orth = wk * non_orth_a(k, nj, j) + wj * non_orth_b(nk, k, j);
+
+              for (int i = 0; i < n1; ++i) {
+                const double flux = orth * mat.scsDeriv(s, i) + non_orth * mat.scsInterp(s, i);
+                const int col = idx<n1>(k, j, i);
+                lhs(row_minus, col) += flux;
+                lhs(row_plus, col) -= flux;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // flux past constant yhat surfaces
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int k = 0; k < n1; ++k) {
+        for (int n = 0; n < n1; ++n) {
+          for (int i = 0; i < n1; ++i) {
+            double sum_x = 0.0;
+            double sum_z = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum_x += mat.nodalWeightDeriv(n, l, i) * metric(YH, XH, s, k, l);
+              sum_z += mat.nodalWeightDeriv(n, l, k) * metric(YH, ZH, s, l, i);
+            }
+            non_orth_a(k, n, i) = sum_x;
+            non_orth_b(n, k, i) = sum_z;
+          }
+        }
+      }
+
+      for (int nk = 0; nk < n1; ++nk) {
+        for (int ni = 0; ni < n1; ++ni) {
+          const int row_minus = idx<n1>(nk, s, ni);
+          const int row_plus = idx<n1>(nk, s + 1, ni);
+          for (int k = 0; k < n1; ++k) {
+            for (int i = 0; i < n1; ++i) {
+              const double wk = mat.nodalWeights(nk, k);
+              const double wi = mat.nodalWeights(ni, i);
+              const double orth = wk * wi * metric(YH, YH, s, k, i);
+              const double non_orth = wk * non_orth_a(k, ni, i) + wi * non_orth_b(nk, k, i);
+
+              for (int j = 0; j < n1; ++j) {
+                const double flux = orth * mat.scsDeriv(s, j) + non_orth * mat.scsInterp(s, j);
+                const int col = idx<n1>(k, j, i);
+                lhs(row_minus, col) += flux;
+                lhs(row_plus, col) -= flux;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // flux past constant zhat surfaces
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int j = 0; j < n1; ++j) {
+        for (int n = 0; n < n1; ++n) {
+          for (int i = 0; i < n1; ++i) {
+            double sum_x = 0.0;
+            double sum_y = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum_x += mat.nodalWeightDeriv(n, l, i) * metric(ZH, XH, s, j, l);
+              sum_y += mat.nodalWeightDeriv(n, l, j) * metric(ZH, YH, s, l, i);
+            }
+            non_orth_a(j, n, i) = sum_x;
+            non_orth_b(n, j, i) = sum_y;
+          }
+        }
+      }
+
+      for (int nj = 0; nj < n1; ++nj) {
+        for (int ni = 0; ni < n1; ++ni) {
+          const int row_minus = idx<n1>(s, nj, ni);
+          const int row_plus = idx<n1>(s + 1, nj, ni);
+          for (int j = 0; j < n1; ++j) {
+            for (int i = 0; i < n1; ++i) {
+              const double wj = mat.nodalWeights(nj, j);
+              const double wi = mat.nodalWeights(ni, i);
+              const double orth = wj * wi * metric(ZH, ZH, s, j, i);
+              const double non_orth = wj * non_orth_a(j, ni, i) + wi * non_orth_b(nj, j, i);
+
+              for (int k = 0; k < n1; ++k) {
+                const double flux = orth * mat.scsDeriv(s, k) + non_orth * mat.scsInterp(s, k);
+                const int col = idx<n1>(k, j, i);
+                lhs(row_minus, col) += flux;
+                lhs(row_plus, col) -= flux;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void add_elemental_laplacian_diagonal(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename HexViews<poly_order>::scs_tensor_array& metric,
+    typename HexViews<poly_order>::nodal_scalar_array& diag)
+  {
+    /*
+     * Diagonal of add_elemental_laplacian_matrix, without forming the rest of the matrix
+     */
+    using TopoView = HexViews<poly_order>;
+    constexpr int n1 = TopoView::nodes1D;
+
+    // flux past constant xhat surfaces
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int nk = 0; nk < n1; ++nk) {
+        for (int nj = 0; nj < n1; ++nj) {
+          const double wk = mat.nodalWeights(nk, nk);
+          const double wj = mat.nodalWeights(nj, nj);
+          const double orth = wk * wj * metric(XH, XH, s, nk, nj);
+
+          double non_orth_y = 0.0;
+          double non_orth_z = 0.0;
+          for (int l = 0; l < n1; ++l) {
+            non_orth_y += mat.nodalWeightDeriv(nj, l, nj) * metric(XH, YH, s, nk, l);
+            non_orth_z += mat.nodalWeightDeriv(nk, l, nk) * metric(XH, ZH, s, l, nj);
+          }
+          const double non_orth = wk * non_orth_y + wj * non_orth_z;
+
+          diag(nk, nj, s + 0) += orth * mat.scsDeriv(s, s + 0) + non_orth * mat.scsInterp(s, s + 0);
+          diag(nk, nj, s + 1) -= orth * mat.scsDeriv(s, s + 1) + non_orth * mat.scsInterp(s, s + 1);
+        }
+      }
+    }
+
+    // flux past constant yhat surfaces
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int nk = 0; nk < n1; ++nk) {
+        for (int ni = 0; ni < n1; ++ni) {
+          const double wk = mat.nodalWeights(nk, nk);
+          const double wi = mat.nodalWeights(ni, ni);
+          const double orth = wk * wi * metric(YH, YH, s, nk, ni);
+
+          double non_orth_x = 0.0;
+          double non_orth_z = 0.0;
+          for (int l = 0; l < n1; ++l) {
+            non_orth_x += mat.nodalWeightDeriv(ni, l, ni) * metric(YH, XH, s, nk, l);
+            non_orth_z += mat.nodalWeightDeriv(nk, l, nk) * metric(YH, ZH, s, l, ni);
+          }
+          const double non_orth = wk * non_orth_x + wi * non_orth_z;
+
+          diag(nk, s + 0, ni) += orth * mat.scsDeriv(s, s + 0) + non_orth * mat.scsInterp(s, s + 0);
+          diag(nk, s + 1, ni) -= orth * mat.scsDeriv(s, s + 1) + non_orth * mat.scsInterp(s, s + 1);
+        }
+      }
+    }
+
+    // flux past constant zhat surfaces
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int nj = 0; nj < n1; ++nj) {
+        for (int ni = 0; ni < n1; ++ni) {
+          const double wj = mat.nodalWeights(nj, nj);
+          const double wi = mat.nodalWeights(ni, ni);
+          const double orth = wj * wi * metric(ZH, ZH, s, nj, ni);
+
+          double non_orth_x = 0.0;
+          double non_orth_y = 0.0;
+          for (int l = 0; l < n1; ++l) {
+            non_orth_x += mat.nodalWeightDeriv(ni, l, ni) * metric(ZH, XH, s, nj, l);
+            non_orth_y += mat.nodalWeightDeriv(nj, l, nj) * metric(ZH, YH, s, l, ni);
+          }
+          const double non_orth = wj * non_orth_x + wi * non_orth_y;
+
+          diag(s + 0, nj, ni) += orth * mat.scsDeriv(s, s + 0) + non_orth * mat.scsInterp(s, s + 0);
+          diag(s + 1, nj, ni) -= orth * mat.scsDeriv(s, s + 1) + non_orth * mat.scsInterp(s, s + 1);
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void add_elemental_laplacian_action(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename HexViews<poly_order>::scs_tensor_array& metric,
+    const typename HexViews<poly_order>::nodal_scalar_array& scalar,
+    typename HexViews<poly_order>::nodal_scalar_array& residual,
+    ScratchWorkspace& work)
+  {
+    /*
+     * Compute the action of the LHS on a scalar field as a sequence of 1D contractions
+     * instead of a large (N^3 x N^3) matvec
+     */
+    using TopoView = HexViews<poly_order>;
+    constexpr int n1 = TopoView::nodes1D;
+
+    ScratchScope scope(work);
+    auto grad_phi = work.get_view<typename TopoView::scs_vector_array>();
+    auto integrand = work.get_view<typename TopoView::scs_scalar_array>();
+    auto flux = work.get_view<typename TopoView::scs_scalar_array>();
+
+    // gradient at constant xhat surfaces
+    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
+
+    // apply metric transformation
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int k = 0; k < n1; ++k) {
+        for (int j = 0; j < n1; ++j) {
+          integrand(s, k, j) = metric(XH, XH, s, k, j) * grad_phi(XH, s, k, j)
+                             + metric(XH, YH, s, k, j) * grad_phi(YH, s, k, j)
+                             + metric(XH, ZH, s, k, j) * grad_phi(ZH, s, k, j);
+        }
+      }
+    }
+
+    // integration / scattering of surface fluxes
+    HighOrderOperators::volume_2D<poly_order>(mat.nodalWeights, integrand, flux, work);
+    HighOrderOperators::scatter_flux_xhat<poly_order>(flux, residual);
+
+    // gradient at constant yhat surfaces
+    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
+
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int k = 0; k < n1; ++k) {
+        for (int i = 0; i < n1; ++i) {
+          integrand(s, k, i) = metric(YH, XH, s, k, i) * grad_phi(XH, s, k, i)
+                             + metric(YH, YH, s, k, i) * grad_phi(YH, s, k, i)
+                             + metric(YH, ZH, s, k, i) * grad_phi(ZH, s, k, i);
+        }
+      }
+    }
+
+    HighOrderOperators::volume_2D<poly_order>(mat.nodalWeights, integrand, flux, work);
+    HighOrderOperators::scatter_flux_yhat<poly_order>(flux, residual);
+
+    // gradient at constant zhat surfaces
+    HighOrderOperators::scs_zhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
+
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int j = 0; j < n1; ++j) {
+        for (int i = 0; i < n1; ++i) {
+          integrand(s, j, i) = metric(ZH, XH, s, j, i) * grad_phi(XH, s, j, i)
+                             + metric(ZH, YH, s, j, i) * grad_phi(YH, s, j, i)
+                             + metric(ZH, ZH, s, j, i) * grad_phi(ZH, s, j, i);
+        }
+      }
+    }
+
+    HighOrderOperators::volume_2D<poly_order>(mat.nodalWeights, integrand, flux, work);
+    HighOrderOperators::scatter_flux_zhat<poly_order>(flux, residual);
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void add_volumetric_source(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename HexViews<poly_order>::nodal_scalar_array& volume_metric,
+    const typename HexViews<poly_order>::nodal_scalar_array& nodal_source,
+    typename HexViews<poly_order>::nodal_scalar_array& rhs,
+    ScratchWorkspace& work)
+  {
+    using TopoView = HexViews<poly_order>;
+
+    for (unsigned k = 0; k < TopoView::nodes1D; ++k) {
+      for (unsigned j = 0; j < TopoView::nodes1D; ++j) {
+        for (unsigned i = 0; i < TopoView::nodes1D; ++i) {
+          nodal_source(k,j,i) *= volume_metric(k,j,i);
+        }
+      }
+    }
+
+    // computes the contribution of a volumetric source to the right-hand side
+    HighOrderOperators::volume_3D<poly_order>(mat.nodalWeights, nodal_source, rhs, work);
+  }
+
+} // namespace TensorAssembly
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
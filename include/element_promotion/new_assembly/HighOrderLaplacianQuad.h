@@ -9,6 +9,7 @@
 
 #include <element_promotion/new_assembly/HighOrderOperatorsQuad.h>
 #include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <element_promotion/new_assembly/DirectionEnums.h>
 #include <TopologyViews.h>
 
 namespace sierra {
@@ -18,11 +19,6 @@ namespace TensorAssembly {
   template <unsigned nodes1D>
   int idx(int i, int j) { return i*nodes1D+j; };
 
-  enum Direction {
-    XH = 0,
-    YH = 1
-  };
-
   template <unsigned poly_order>
   void add_elemental_laplacian_matrix(
     const CoefficientMatrices<poly_order>& mat,
@@ -31,121 +27,108 @@ namespace TensorAssembly {
   {
     /*
      * Computes the elemental lhs for the Laplacian operator given
-     * the correct grid metrics, split into boundary and interior terms.
+     * the correct grid metrics.  The flux through each subcontrol surface is
+     * added to the node behind it and subtracted from the node in front of it,
+     * so every surface is visited once.
+     *
+     * For the flux through the constant xhat line "s" between the nodes (n, s) and (n, s+1),
+     * the derivative of node (j,i) is
+     *
+     *  W(n,j) M_xx(s,j) S(s,i) + I(s,i) sum_k WD(n,k,j) M_xy(s,k)
+     *
+     * with WD(n,k,j) = W(n,k) D(k,j) precomputed in the coefficient matrices
      */
     using TopoView = QuadViews<poly_order>;
+    constexpr int n1 = TopoView::nodes1D;
 
     static_assert (TopoView::dim == 2,"Only 2D implemented");
 
-    // flux past constant yhat lines
-    for (int n = 0; n < TopoView::nodes1D; ++n) {
-      // x- element boundary
-      constexpr int m_minus = 0;
-      for (int j = 0; j < TopoView::nodes1D; ++j) {
-        double orth = mat.nodalWeights(n, j) * metric(XH, XH, m_minus, j);
-        double non_orth = 0.0;
-        for (int k = 0; k < TopoView::nodes1D; ++k) {
-          non_orth += mat.nodalWeights(n, k) * mat.nodalDeriv(k, j) * metric(XH, YH, m_minus, k);
-        }
-
-        for (int i = 0; i < TopoView::nodes1D; ++i) {
-          lhs(idx<TopoView::nodes1D>(n, m_minus), idx<TopoView::nodes1D>(j, i)) +=
-              orth * mat.scsDeriv(m_minus, i) + non_orth * mat.scsInterp(m_minus, i);
-        }
-      }
+    // flux past constant xhat lines
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int n = 0; n < n1; ++n) {
+        const int row_minus = idx<n1>(n, s);
+        const int row_plus = idx<n1>(n, s + 1);
+        for (int j = 0; j < n1; ++j) {
+          const double orth = mat.nodalWeights(n, j) * metric(XH, XH, s, j);
 
-      // interior flux
-      for (int m = 1; m < TopoView::nodes1D - 1; ++m) {
-        for (int j = 0; j < TopoView::nodes1D; ++j) {
-          const double w = mat.nodalWeights(n, j);
-          const double orthm1 = w * metric(XH, XH, m - 1, j);
-          const double orthp0 = w * metric(XH, XH, m + 0, j);
-
-          double non_orthp0 = 0.0;
-          double non_orthm1 = 0.0;
-          for (int k = 0; k < TopoView::nodes1D; ++k) {
-            const double wd = mat.nodalWeights(n, k) * mat.nodalDeriv(k, j);
-            non_orthm1 += wd * metric(XH, YH, m - 1, k);
-            non_orthp0 += wd * metric(XH, YH, m + 0, k);
+          double non_orth = 0.0;
+          for (int k = 0; k < n1; ++k) {
+            non_orth += mat.nodalWeightDeriv(n, k, j) * metric(XH, YH, s, k);
           }
 
-          for (int i = 0; i < TopoView::nodes1D; ++i) {
-            const double fm = orthm1 * mat.scsDeriv(m - 1, i) + non_orthm1 * mat.scsInterp(m - 1, i);
-            const double fp = orthp0 * mat.scsDeriv(m + 0, i) + non_orthp0 * mat.scsInterp(m + 0, i);
-            lhs(idx<TopoView::nodes1D>(n, m), idx<TopoView::nodes1D>(j, i)) += (fp - fm);
+          for (int i = 0; i < n1; ++i) {
+            const double flux = orth * mat.scsDeriv(s, i) + non_orth * mat.scsInterp(s, i);
+            const int col = idx<n1>(j, i);
+            lhs(row_minus, col) += flux;
+            lhs(row_plus, col) -= flux;
           }
         }
       }
+    }
 
-      // x+ element boundary
-      constexpr int m_plus = TopoView::nodes1D - 1;
-      for (int j = 0; j < TopoView::nodes1D; ++j) {
-        const double orth = mat.nodalWeights(n, j) * metric(XH, XH, m_plus - 1, j);
+    // flux past constant yhat lines
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int m = 0; m < n1; ++m) {
+        const int row_minus = idx<n1>(s, m);
+        const int row_plus = idx<n1>(s + 1, m);
+        for (int i = 0; i < n1; ++i) {
+          const double orth = mat.nodalWeights(m, i) * metric(YH, YH, s, i);
 
-        double non_orth = 0.0;
-        for (int k = 0; k < TopoView::nodes1D; ++k) {
-          non_orth += mat.nodalWeights(n, k) * mat.nodalDeriv(k, j) * metric(XH, YH, m_plus - 1, k);
-        }
-        for (int i = 0; i < TopoView::nodes1D; ++i) {
-          lhs(idx<TopoView::nodes1D>(n, m_plus), idx<TopoView::nodes1D>(j, i)) -=
-              orth * mat.scsDeriv(m_plus - 1, i) + non_orth * mat.scsInterp(m_plus - 1, i);
+          double non_orth = 0.0;
+          for (int k = 0; k < n1; ++k) {
+            non_orth += mat.nodalWeightDeriv(m, k, i) * metric(YH, XH, s, k);
+          }
+
+          for (int j = 0; j < n1; ++j) {
+            const double flux = orth * mat.scsDeriv(s, j) + non_orth * mat.scsInterp(s, j);
+            const int col = idx<n1>(j, i);
+            lhs(row_minus, col) += flux;
+            lhs(row_plus, col) -= flux;
+          }
         }
       }
     }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void add_elemental_laplacian_diagonal(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename QuadViews<poly_order>::scs_tensor_array& metric,
+    typename QuadViews<poly_order>::nodal_scalar_array& diag)
+  {
+    /*
+     * Diagonal of add_elemental_laplacian_matrix, without forming the rest of the matrix
+     */
+    using TopoView = QuadViews<poly_order>;
+    constexpr int n1 = TopoView::nodes1D;
 
     // flux past constant xhat lines
-    for (int m = 0; m < TopoView::nodes1D; ++m) {
-      // y+ boundary
-      constexpr int n_minus = 0;
-      for (int i = 0; i < TopoView::nodes1D; ++i) {
-        const double orth = mat.nodalWeights(m, i) * metric(YH, YH, n_minus, i);
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int n = 0; n < n1; ++n) {
+        const double orth = mat.nodalWeights(n, n) * metric(XH, XH, s, n);
 
         double non_orth = 0.0;
-        for (int k = 0; k < TopoView::nodes1D; ++k) {
-          non_orth += mat.nodalWeights(m, k) * mat.nodalDeriv(k, i) * metric(YH, XH, n_minus, k);
+        for (int k = 0; k < n1; ++k) {
+          non_orth += mat.nodalWeightDeriv(n, k, n) * metric(XH, YH, s, k);
         }
-        for (int j = 0; j < TopoView::nodes1D; ++j) {
-          lhs(idx<TopoView::nodes1D>(n_minus, m), idx<TopoView::nodes1D>(j, i)) +=
-              orth * mat.scsDeriv(n_minus, j) + non_orth * mat.scsInterp(n_minus, j);
-        }
-      }
-
-      // interior flux
-      for (int n = 1; n < TopoView::nodes1D - 1; ++n) {
-        for (int i = 0; i < TopoView::nodes1D; ++i) {
-          const double w = mat.nodalWeights(m, i);
-          const double orthm1 = w * metric(YH, YH, n - 1, i);
-          const double orthp0 = w * metric(YH, YH, n + 0, i);
-
-          double non_orthp0 = 0.0;
-          double non_orthm1 = 0.0;
-          for (int k = 0; k < TopoView::nodes1D; ++k) {
-            const double wd = mat.nodalWeights(m, k) * mat.nodalDeriv(k, i);
-            non_orthm1 += wd * metric(YH, XH, n - 1, k);
-            non_orthp0 += wd * metric(YH, XH, n + 0, k);
-          }
 
-          for (int j = 0; j < TopoView::nodes1D; ++j) {
-            const double fm = orthm1 * mat.scsDeriv(n - 1, j) + non_orthm1 * mat.scsInterp(n - 1, j);
-            const double fp = orthp0 * mat.scsDeriv(n + 0, j) + non_orthp0 * mat.scsInterp(n + 0, j);
-            lhs(idx<TopoView::nodes1D>(n, m), idx<TopoView::nodes1D>(j, i)) += (fp - fm);
-          }
-        }
+        diag(n, s + 0) += orth * mat.scsDeriv(s, s + 0) + non_orth * mat.scsInterp(s, s + 0);
+        diag(n, s + 1) -= orth * mat.scsDeriv(s, s + 1) + non_orth * mat.scsInterp(s, s + 1);
       }
+    }
 
-      // y+ boundary
-      constexpr int n_plus = TopoView::nodes1D - 1;
-      for (int i = 0; i < TopoView::nodes1D; ++i) {
-        const double orth = mat.nodalWeights(m, i) * metric(YH, YH, n_plus - 1, i);
+    // flux past constant yhat lines
+    for (int s = 0; s < n1 - 1; ++s) {
+      for (int m = 0; m < n1; ++m) {
+        const double orth = mat.nodalWeights(m, m) * metric(YH, YH, s, m);
 
         double non_orth = 0.0;
-        for (int k = 0; k < TopoView::nodes1D; ++k) {
-          non_orth += mat.nodalWeights(m, k) * mat.nodalDeriv(k, i) * metric(YH, XH, n_plus - 1, k);
-        }
-        for (int j = 0; j < TopoView::nodes1D; ++j) {
-          lhs(idx<TopoView::nodes1D>(n_plus, m), idx<TopoView::nodes1D>(j, i)) -=
-              orth * mat.scsDeriv(n_plus - 1, j) + non_orth * mat.scsInterp(n_plus - 1, j);
+        for (int k = 0; k < n1; ++k) {
+          non_orth += mat.nodalWeightDeriv(m, k, m) * metric(YH, XH, s, k);
         }
+
+        diag(s + 0, m) += orth * mat.scsDeriv(s, s + 0) + non_orth * mat.scsInterp(s, s + 0);
+        diag(s + 1, m) -= orth * mat.scsDeriv(s, s + 1) + non_orth * mat.scsInterp(s, s + 1);
       }
     }
   }
@@ -155,8 +138,8 @@ namespace TensorAssembly {
     const CoefficientMatrices<poly_order>& mat,
     const typename QuadViews<poly_order>::scs_tensor_array& metric,
     const typename QuadViews<poly_order>::nodal_scalar_array& scalar,
-    typename QuadViews<poly_order>::nodal_scalar_array& residual
-  )
+    typename QuadViews<poly_order>::nodal_scalar_array& residual,
+    ScratchWorkspace& work)
   {
     /*
      * Compute the action of the LHS on a scalar field as a sequence of small (N x N), dense matrix-matrix
@@ -164,12 +147,15 @@ namespace TensorAssembly {
      */
     using TopoView = QuadViews<poly_order>;
 
+    ScratchScope scope(work);
+    auto grad_phi = work.get_view<typename TopoView::nodal_vector_array>();
+    auto integrand = work.get_view<typename TopoView::nodal_scalar_array>();
+    auto flux = work.get_view<typename TopoView::nodal_scalar_array>();
+
     // gradient at constant xhat surfaces
-    typename TopoView::nodal_vector_array grad_phi("gp");
-    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi);
+    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
 
     // apply metric transformation
-    typename TopoView::nodal_scalar_array integrand("");
     for (unsigned j = 0; j < TopoView::nodes1D - 1; ++j) {
       for (unsigned i = 0; i < TopoView::nodes1D; ++i) {
         integrand(j, i) = metric(XH,XH, j, i) * grad_phi(XH, j, i) + metric(XH,YH, j, i) * grad_phi(YH, j, i);
@@ -177,12 +163,11 @@ namespace TensorAssembly {
     }
 
     // integration / scattering of surface fluxes
-    typename TopoView::nodal_scalar_array flux("");
     HighOrderOperators::volume_1D<poly_order>(mat.nodalWeights, integrand, flux);
     HighOrderOperators::scatter_flux_xhat<poly_order>(flux, residual);
 
     // gradient at constant yhat surfaces
-    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi);
+    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
 
     // apply metric transformation
     for (unsigned j = 0; j < TopoView::nodes1D - 1; ++j) {
@@ -201,7 +186,8 @@ namespace TensorAssembly {
     const CoefficientMatrices<poly_order>& mat,
     const typename QuadViews<poly_order>::nodal_scalar_array& volume_metric,
     const typename QuadViews<poly_order>::nodal_scalar_array& nodal_source,
-    typename QuadViews<poly_order>::nodal_scalar_array& rhs)
+    typename QuadViews<poly_order>::nodal_scalar_array& rhs,
+    ScratchWorkspace& work)
   {
     using TopoView = QuadViews<poly_order>;
 
@@ -214,7 +200,71 @@ namespace TensorAssembly {
     }
 
     // computes the contribution of a volumetric source to the right-hand side
-    HighOrderOperators::volume_2D<poly_order>(mat.nodalWeights, nodal_source, rhs);
+    HighOrderOperators::volume_2D<poly_order>(mat.nodalWeights, nodal_source, rhs, work);
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void add_elemental_laplacian_action(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename QuadBatchViews<poly_order>::scs_tensor_array& metric,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& scalar,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& residual,
+    ScratchWorkspace& work)
+  {
+    // add_elemental_laplacian_action for a batch of elements, one per lane
+    using BatchView = QuadBatchViews<poly_order>;
+    constexpr int lanes = BatchView::lanes;
+
+    ScratchScope scope(work);
+    auto grad_phi = work.get_view<typename BatchView::nodal_vector_array>();
+    auto integrand = work.get_view<typename BatchView::nodal_scalar_array>();
+    auto flux = work.get_view<typename BatchView::nodal_scalar_array>();
+
+    HighOrderOperators::scs_xhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
+    for (unsigned j = 0; j < BatchView::nodes1D - 1; ++j) {
+      for (unsigned i = 0; i < BatchView::nodes1D; ++i) {
+        for (int l = 0; l < lanes; ++l) {
+          integrand(j, i, l) = metric(XH,XH, j, i, l) * grad_phi(XH, j, i, l)
+                             + metric(XH,YH, j, i, l) * grad_phi(YH, j, i, l);
+        }
+      }
+    }
+    HighOrderOperators::volume_1D<poly_order>(mat.nodalWeights, integrand, flux);
+    HighOrderOperators::scatter_flux_xhat<poly_order>(flux, residual);
+
+    HighOrderOperators::scs_yhat_grad<poly_order>(mat.scsInterp, mat.scsDeriv, mat.nodalDeriv, scalar, grad_phi, work);
+    for (unsigned j = 0; j < BatchView::nodes1D - 1; ++j) {
+      for (unsigned i = 0; i < BatchView::nodes1D; ++i) {
+        for (int l = 0; l < lanes; ++l) {
+          integrand(j, i, l) = metric(YH,XH, j, i, l) * grad_phi(XH, j, i, l)
+                             + metric(YH,YH, j, i, l) * grad_phi(YH, j, i, l);
+        }
+      }
+    }
+    HighOrderOperators::volume_1D<poly_order>(mat.nodalWeights, integrand, flux);
+    HighOrderOperators::scatter_flux_yhat<poly_order>(flux, residual);
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void add_volumetric_source(
+    const CoefficientMatrices<poly_order>& mat,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& volume_metric,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& nodal_source,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& rhs,
+    ScratchWorkspace& work)
+  {
+    // add_volumetric_source for a batch of elements, one per lane
+    using BatchView = QuadBatchViews<poly_order>;
+    constexpr int lanes = BatchView::lanes;
+
+    for (unsigned j = 0; j < BatchView::nodes1D; ++j) {
+      for (unsigned i = 0; i < BatchView::nodes1D; ++i) {
+        for (int l = 0; l < lanes; ++l) {
+          nodal_source(j,i,l) *= volume_metric(j,i,l);
+        }
+      }
+    }
+    HighOrderOperators::volume_2D<poly_order>(mat.nodalWeights, nodal_source, rhs, work);
   }
 
 } // namespace HighOrderLaplacianQuad
@@ -0,0 +1,448 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef HighOrderOperatorsHex_h
+#define HighOrderOperatorsHex_h
+
+#include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <element_promotion/new_assembly/DirectionEnums.h>
+#include <element_promotion/new_assembly/ScratchWorkspace.h>
+#include <TopologyViews.h>
+
+namespace sierra {
+namespace naluUnit {
+namespace HighOrderOperators {
+  namespace HexInternal {
+    /*
+     * Nodal arrays are ordered (k,j,i) with i the xhat-index, j the yhat-index
+     * and k the zhat-index.  Arrays evaluated at the subcontrol surfaces
+     * of a direction are ordered (s,a,b), with s the scs index and (a,b) the two remaining
+     * nodal indices, in the same relative order as the nodal array.
+     *
+     * The 1D coefficient matrices are row-major, (point, node)
+     */
+    template <unsigned poly_order>
+    inline int nidx(int k, int j, int i) { return (k * (poly_order + 1) + j) * (poly_order + 1) + i; }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void Dx(const double* nodalDeriv, const double* in, double* out)
+    {
+      // computes xhat-derivative at nodes
+      constexpr int n1 = poly_order + 1;
+      for (int k = 0; k < n1; ++k) {
+        for (int j = 0; j < n1; ++j) {
+          for (int i = 0; i < n1; ++i) {
+            double sum = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum += nodalDeriv[i * n1 + l] * in[nidx<poly_order>(k, j, l)];
+            }
+            out[nidx<poly_order>(k, j, i)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void Dy(const double* nodalDeriv, const double* in, double* out)
+    {
+      // computes yhat-derivative at nodes
+      constexpr int n1 = poly_order + 1;
+      for (int k = 0; k < n1; ++k) {
+        for (int j = 0; j < n1; ++j) {
+          for (int i = 0; i < n1; ++i) {
+            double sum = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum += nodalDeriv[j * n1 + l] * in[nidx<poly_order>(k, l, i)];
+            }
+            out[nidx<poly_order>(k, j, i)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void Dz(const double* nodalDeriv, const double* in, double* out)
+    {
+      // computes zhat-derivative at nodes
+      constexpr int n1 = poly_order + 1;
+      for (int k = 0; k < n1; ++k) {
+        for (int j = 0; j < n1; ++j) {
+          for (int i = 0; i < n1; ++i) {
+            double sum = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum += nodalDeriv[k * n1 + l] * in[nidx<poly_order>(l, j, i)];
+            }
+            out[nidx<poly_order>(k, j, i)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void apply_xhat(const double* coeff, const double* in, double* out)
+    {
+      // applies a 1D scs operator (interpolant or derivative) in the xhat direction,
+      // out(s,k,j) = sum_l coeff(s,l) in(k,j,l)
+      constexpr int n1 = poly_order + 1;
+      for (unsigned s = 0; s < poly_order; ++s) {
+        for (int k = 0; k < n1; ++k) {
+          for (int j = 0; j < n1; ++j) {
+            double sum = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum += coeff[s * n1 + l] * in[nidx<poly_order>(k, j, l)];
+            }
+            out[nidx<poly_order>(s, k, j)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void apply_yhat(const double* coeff, const double* in, double* out)
+    {
+      // out(s,k,i) = sum_l coeff(s,l) in(k,l,i)
+      constexpr int n1 = poly_order + 1;
+      for (unsigned s = 0; s < poly_order; ++s) {
+        for (int k = 0; k < n1; ++k) {
+          for (int i = 0; i < n1; ++i) {
+            double sum = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum += coeff[s * n1 + l] * in[nidx<poly_order>(k, l, i)];
+            }
+            out[nidx<poly_order>(s, k, i)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void apply_zhat(const double* coeff, const double* in, double* out)
+    {
+      // out(s,j,i) = sum_l coeff(s,l) in(l,j,i)
+      constexpr int n1 = poly_order + 1;
+      for (unsigned s = 0; s < poly_order; ++s) {
+        for (int j = 0; j < n1; ++j) {
+          for (int i = 0; i < n1; ++i) {
+            double sum = 0.0;
+            for (int l = 0; l < n1; ++l) {
+              sum += coeff[s * n1 + l] * in[nidx<poly_order>(l, j, i)];
+            }
+            out[nidx<poly_order>(s, j, i)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void D_slow(const double* nodalDeriv, const double* in, double* out)
+    {
+      // derivative of an scs array along its slower-varying in-surface index,
+      // out(s,a,b) = sum_m D(a,m) in(s,m,b)
+      constexpr int n1 = poly_order + 1;
+      for (unsigned s = 0; s < poly_order; ++s) {
+        for (int a = 0; a < n1; ++a) {
+          for (int b = 0; b < n1; ++b) {
+            double sum = 0.0;
+            for (int m = 0; m < n1; ++m) {
+              sum += nodalDeriv[a * n1 + m] * in[nidx<poly_order>(s, m, b)];
+            }
+            out[nidx<poly_order>(s, a, b)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void D_fast(const double* nodalDeriv, const double* in, double* out)
+    {
+      // derivative of an scs array along its faster-varying in-surface index,
+      // out(s,a,b) = sum_m D(b,m) in(s,a,m)
+      constexpr int n1 = poly_order + 1;
+      for (unsigned s = 0; s < poly_order; ++s) {
+        for (int a = 0; a < n1; ++a) {
+          for (int b = 0; b < n1; ++b) {
+            double sum = 0.0;
+            for (int m = 0; m < n1; ++m) {
+              sum += nodalDeriv[b * n1 + m] * in[nidx<poly_order>(s, a, m)];
+            }
+            out[nidx<poly_order>(s, a, b)] = sum;
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void scs_xhat_grad(
+      const double* scsInterp,
+      const double* scsDeriv,
+      const double* nodalDeriv,
+      const double* in,
+      double* gx, double* gy, double* gz,
+      double* temp)
+    {
+      // computes reference-element gradient at scs of constant xhat coordinate
+      apply_xhat<poly_order>(scsDeriv, in, gx);
+      apply_xhat<poly_order>(scsInterp, in, temp);
+      D_fast<poly_order>(nodalDeriv, temp, gy);
+      D_slow<poly_order>(nodalDeriv, temp, gz);
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void scs_yhat_grad(
+      const double* scsInterp,
+      const double* scsDeriv,
+      const double* nodalDeriv,
+      const double* in,
+      double* gx, double* gy, double* gz,
+      double* temp)
+    {
+      // computes reference-element gradient at scs of constant yhat coordinate
+      apply_yhat<poly_order>(scsDeriv, in, gy);
+      apply_yhat<poly_order>(scsInterp, in, temp);
+      D_fast<poly_order>(nodalDeriv, temp, gx);
+      D_slow<poly_order>(nodalDeriv, temp, gz);
+    }
+    //--------------------------------------------------------------------------
+    template <unsigned poly_order>
+    void scs_zhat_grad(
+      const double* scsInterp,
+      const double* scsDeriv,
+      const double* nodalDeriv,
+      const double* in,
+      double* gx, double* gy, double* gz,
+      double* temp)
+    {
+      // computes reference-element gradient at scs of constant zhat coordinate
+      apply_zhat<poly_order>(scsDeriv, in, gz);
+      apply_zhat<poly_order>(scsInterp, in, temp);
+      D_fast<poly_order>(nodalDeriv, temp, gx);
+      D_slow<poly_order>(nodalDeriv, temp, gy);
+    }
+  }
+
+  template <unsigned poly_order>
+  void nodal_grad(
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_scalar_array& f,
+    typename HexViews<poly_order>::nodal_vector_array& grad)
+  {
+    // computes reference-element gradient at nodes
+    HexInternal::Dx<poly_order>(nodalDeriv.data(), &f(0,0,0), &grad(XH,0,0,0));
+    HexInternal::Dy<poly_order>(nodalDeriv.data(), &f(0,0,0), &grad(YH,0,0,0));
+    HexInternal::Dz<poly_order>(nodalDeriv.data(), &f(0,0,0), &grad(ZH,0,0,0));
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void nodal_grad(
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_vector_array& f,
+    typename HexViews<poly_order>::nodal_tensor_array& grad)
+  {
+    // computes reference-element gradient at nodes, grad(component, direction)
+    for (int d = 0; d < 3; ++d) {
+      HexInternal::Dx<poly_order>(nodalDeriv.data(), &f(d,0,0,0), &grad(d,XH,0,0,0));
+      HexInternal::Dy<poly_order>(nodalDeriv.data(), &f(d,0,0,0), &grad(d,YH,0,0,0));
+      HexInternal::Dz<poly_order>(nodalDeriv.data(), &f(d,0,0,0), &grad(d,ZH,0,0,0));
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_xhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_scalar_array& f,
+    typename HexViews<poly_order>::scs_vector_array& grad,
+    ScratchWorkspace& work)
+  {
+    // computes reference-element gradient at scs of constant xhat coordinate
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    HexInternal::scs_xhat_grad<poly_order>(scsInterp.data(), scsDeriv.data(), nodalDeriv.data(),
+      &f(0,0,0), &grad(XH,0,0,0), &grad(YH,0,0,0), &grad(ZH,0,0,0), temp.data());
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_xhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_vector_array& f,
+    typename HexViews<poly_order>::scs_tensor_array& grad,
+    ScratchWorkspace& work)
+  {
+    // computes reference-element gradient at scs of constant xhat coordinate, grad(component, direction)
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    for (int d = 0; d < 3; ++d) {
+      HexInternal::scs_xhat_grad<poly_order>(scsInterp.data(), scsDeriv.data(), nodalDeriv.data(),
+        &f(d,0,0,0), &grad(d,XH,0,0,0), &grad(d,YH,0,0,0), &grad(d,ZH,0,0,0), temp.data());
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_yhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_scalar_array& f,
+    typename HexViews<poly_order>::scs_vector_array& grad,
+    ScratchWorkspace& work)
+  {
+    // computes reference-element gradient at scs of constant yhat coordinate
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    HexInternal::scs_yhat_grad<poly_order>(scsInterp.data(), scsDeriv.data(), nodalDeriv.data(),
+      &f(0,0,0), &grad(XH,0,0,0), &grad(YH,0,0,0), &grad(ZH,0,0,0), temp.data());
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_yhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_vector_array& f,
+    typename HexViews<poly_order>::scs_tensor_array& grad,
+    ScratchWorkspace& work)
+  {
+    // computes reference-element gradient at scs of constant yhat coordinate, grad(component, direction)
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    for (int d = 0; d < 3; ++d) {
+      HexInternal::scs_yhat_grad<poly_order>(scsInterp.data(), scsDeriv.data(), nodalDeriv.data(),
+        &f(d,0,0,0), &grad(d,XH,0,0,0), &grad(d,YH,0,0,0), &grad(d,ZH,0,0,0), temp.data());
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_zhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_scalar_array& f,
+    typename HexViews<poly_order>::scs_vector_array& grad,
+    ScratchWorkspace& work)
+  {
+    // computes reference-element gradient at scs of constant zhat coordinate
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    HexInternal::scs_zhat_grad<poly_order>(scsInterp.data(), scsDeriv.data(), nodalDeriv.data(),
+      &f(0,0,0), &grad(XH,0,0,0), &grad(YH,0,0,0), &grad(ZH,0,0,0), temp.data());
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_zhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename HexViews<poly_order>::nodal_vector_array& f,
+    typename HexViews<poly_order>::scs_tensor_array& grad,
+    ScratchWorkspace& work)
+  {
+    // computes reference-element gradient at scs of constant zhat coordinate, grad(component, direction)
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    for (int d = 0; d < 3; ++d) {
+      HexInternal::scs_zhat_grad<poly_order>(scsInterp.data(), scsDeriv.data(), nodalDeriv.data(),
+        &f(d,0,0,0), &grad(d,XH,0,0,0), &grad(d,YH,0,0,0), &grad(d,ZH,0,0,0), temp.data());
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void volume_2D(
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalWeights,
+    const typename HexViews<poly_order>::scs_scalar_array& f,
+    typename HexViews<poly_order>::scs_scalar_array& f_bar,
+    ScratchWorkspace& work)
+  {
+    // computes volume integral over 2D surfaces (e.g. "scs" in 3D)
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename HexViews<poly_order>::scs_scalar_array>();
+    HexInternal::D_fast<poly_order>(nodalWeights.data(), f.data(), temp.data());
+    HexInternal::D_slow<poly_order>(nodalWeights.data(), temp.data(), f_bar.data());
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void volume_3D(
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalWeights,
+    const typename HexViews<poly_order>::nodal_scalar_array& f,
+    typename HexViews<poly_order>::nodal_scalar_array& f_bar,
+    ScratchWorkspace& work)
+  {
+    // computes volume integral along 3D volumes (e.g. "scv" in 3D) and adds it to f_bar
+    ScratchScope scope(work);
+    auto temp1 = work.get_view<typename HexViews<poly_order>::nodal_scalar_array>();
+    auto temp2 = work.get_view<typename HexViews<poly_order>::nodal_scalar_array>();
+    HexInternal::Dx<poly_order>(nodalWeights.data(), f.data(), temp1.data());
+    HexInternal::Dy<poly_order>(nodalWeights.data(), temp1.data(), temp2.data());
+    HexInternal::Dz<poly_order>(nodalWeights.data(), temp2.data(), temp1.data());
+
+    constexpr int n1 = poly_order + 1;
+    for (int k = 0; k < n1; ++k) {
+      for (int j = 0; j < n1; ++j) {
+        for (int i = 0; i < n1; ++i) {
+          f_bar(k,j,i) += temp1(k,j,i);
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scatter_flux_xhat(
+    const typename HexViews<poly_order>::scs_scalar_array& flux,
+    typename HexViews<poly_order>::nodal_scalar_array& residual)
+  {
+    // Scattering of the fluxes through constant xhat surfaces to nodes
+    for (unsigned k = 0; k < poly_order+1; ++k) {
+      for (unsigned j = 0; j < poly_order+1; ++j) {
+        residual(k,j,0) -= flux(0,k,j);
+        for (unsigned p = 1; p < poly_order; ++p) {
+          residual(k,j,p) -= flux(p,k,j) - flux(p-1,k,j);
+        }
+        residual(k,j,poly_order) += flux(poly_order-1,k,j);
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scatter_flux_yhat(
+    const typename HexViews<poly_order>::scs_scalar_array& flux,
+    typename HexViews<poly_order>::nodal_scalar_array& residual)
+  {
+    // Scattering of the fluxes through constant yhat surfaces to nodes
+    for (unsigned k = 0; k < poly_order+1; ++k) {
+      for (unsigned i = 0; i < poly_order+1; ++i) {
+        residual(k,0,i) -= flux(0,k,i);
+        for (unsigned p = 1; p < poly_order; ++p) {
+          residual(k,p,i) -= flux(p,k,i) - flux(p-1,k,i);
+        }
+        residual(k,poly_order,i) += flux(poly_order-1,k,i);
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scatter_flux_zhat(
+    const typename HexViews<poly_order>::scs_scalar_array& flux,
+    typename HexViews<poly_order>::nodal_scalar_array& residual)
+  {
+    // Scattering of the fluxes through constant zhat surfaces to nodes
+    for (unsigned j = 0; j < poly_order+1; ++j) {
+      for (unsigned i = 0; i < poly_order+1; ++i) {
+        residual(0,j,i) -= flux(0,j,i);
+        for (unsigned p = 1; p < poly_order; ++p) {
+          residual(p,j,i) -= flux(p,j,i) - flux(p-1,j,i);
+        }
+        residual(poly_order,j,i) += flux(poly_order-1,j,i);
+      }
+    }
+  }
+
+} // namespace HighOrderOperators
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
@@ -8,6 +8,8 @@
 #define HighOrderOperators_h
 
 #include <element_promotion/new_assembly/CoefficientMatrices.h>
+#include <element_promotion/new_assembly/DirectionEnums.h>
+#include <element_promotion/new_assembly/ScratchWorkspace.h>
 #include <TopologyViews.h>
 #include <Teuchos_BLAS.hpp>
 
@@ -15,7 +17,18 @@ namespace sierra {
 namespace naluUnit {
 namespace HighOrderOperators {
   namespace QuadInternal {
-    void mxm(
+    // matrices larger than this are multiplied with the BLAS instead of the fixed-size kernel
+    constexpr int max_fixed_size_mxm = 16;
+
+    // run-time cap on the size sent to the fixed-size kernel.  Setting it to zero sends every
+    // multiplication to the BLAS, e.g. to compare the two paths
+    inline int& fixed_size_mxm_limit()
+    {
+      static int limit = max_fixed_size_mxm;
+      return limit;
+    }
+
+    inline void mxm(
       Teuchos::ETransp transA,
       Teuchos::ETransp transB,
       int n,
@@ -31,60 +44,105 @@ namespace HighOrderOperators {
         alpha, A, n, B, n,
         beta, C, n);
     }
+    //--------------------------------------------------------------------------
+    template <int n, Teuchos::ETransp transA, Teuchos::ETransp transB>
+    inline void mxm_fixed(
+      double alpha,
+      const double* A,
+      const double* B,
+      double beta,
+      double* C)
+    {
+      /*
+       * Same arguments and (column-major) storage as the GEMM above, but with
+       * the size and transposes known at compile time so that the loops can be completely
+       * unrolled and the inner loop over the rows of C vectorized.  For the small matrices
+       * used here (n <= 16), this avoids the call and dispatch overhead of the BLAS
+       */
+      for (int j = 0; j < n; ++j) {
+        double col[n] = {};
+        for (int l = 0; l < n; ++l) {
+          const double b = (transB == Teuchos::NO_TRANS) ? B[l + j * n] : B[j + l * n];
+          for (int i = 0; i < n; ++i) {
+            col[i] += ((transA == Teuchos::NO_TRANS) ? A[i + l * n] : A[l + i * n]) * b;
+          }
+        }
 
+        if (beta == 0.0) {
+          for (int i = 0; i < n; ++i) {
+            C[i + j * n] = alpha * col[i];
+          }
+        }
+        else {
+          for (int i = 0; i < n; ++i) {
+            C[i + j * n] = alpha * col[i] + beta * C[i + j * n];
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <int n, Teuchos::ETransp transA, Teuchos::ETransp transB>
+    inline void mxm(
+      double alpha,
+      const double* A,
+      const double* B,
+      double beta,
+      double* C)
+    {
+      // selects the fixed-size kernel for small matrices and falls back to the BLAS for large ones
+      if (n <= max_fixed_size_mxm && n <= fixed_size_mxm_limit()) {
+        mxm_fixed<n, transA, transB>(alpha, A, B, beta, C);
+      }
+      else {
+        mxm(transA, transB, n, alpha, A, B, beta, C);
+      }
+    }
+    //--------------------------------------------------------------------------
     template <unsigned poly_order>
     void Dx( const double* nodalDeriv, const double* in, double* out)
     {
       // computes xhat-derivative at nodes
-      mxm(Teuchos::NO_TRANS, Teuchos::NO_TRANS, poly_order+1, 1.0, in, nodalDeriv, 0.0, out);
+      mxm<poly_order+1, Teuchos::NO_TRANS, Teuchos::NO_TRANS>(1.0, in, nodalDeriv, 0.0, out);
     }
     //--------------------------------------------------------------------------
     template <unsigned poly_order>
     void Dy(const double* nodalDeriv, const double* in, double* out)
     {
       // computes yhat-derivative at nodes
-      mxm(Teuchos::TRANS   , Teuchos::NO_TRANS,poly_order+1, 1.0, nodalDeriv, in, 0.0, out);
+      mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, nodalDeriv, in, 0.0, out);
     }
     //--------------------------------------------------------------------------
     template <unsigned poly_order>
     void Dx_xhat(const double* scsDeriv, const double* in, double* out)
     {
       // computes xhat-derivative at scs of constant xhat coordinate
-      mxm(Teuchos::TRANS   , Teuchos::NO_TRANS, poly_order+1, 1.0, in, scsDeriv,  0.0, out);
+      mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, in, scsDeriv,  0.0, out);
     }
     //--------------------------------------------------------------------------
     template <unsigned poly_order>
-    void Dy_xhat(const double* scsInterp, const double* nodalDeriv, const double* in, double* out)
+    void Dy_xhat(const double* scsInterp, const double* nodalDeriv, const double* in, double* out, double* temp)
     {
       // computes yhat-derivative at scs of constant xhat coordinate
-      typename QuadViews<poly_order>::nodal_scalar_array temp("temp");
-      mxm(Teuchos::TRANS   , Teuchos::NO_TRANS, poly_order+1, 1.0, in, scsInterp, 0.0, temp.data());
-      mxm(Teuchos::TRANS   , Teuchos::NO_TRANS, poly_order+1, 1.0, nodalDeriv, temp.data(), 0.0, out);
+      mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, in, scsInterp, 0.0, temp);
+      mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, nodalDeriv, temp, 0.0, out);
     }
     //--------------------------------------------------------------------------
     template <unsigned poly_order>
-    void Dx_yhat(const double* scsInterp, const double* nodalDeriv, const double* in, double* out)
+    void Dx_yhat(const double* scsInterp, const double* nodalDeriv, const double* in, double* out, double* temp)
     {
       // computes xhat-derivative at scs of constant yhat coordinate
-      typename QuadViews<poly_order>::nodal_scalar_array temp("temp");
-      mxm(Teuchos::NO_TRANS, Teuchos::NO_TRANS, poly_order+1, 1.0, in, scsInterp, 0.0, temp.data());
-      mxm(Teuchos::TRANS   , Teuchos::NO_TRANS, poly_order+1, 1.0, nodalDeriv, temp.data(), 0.0, out);
+      mxm<poly_order+1, Teuchos::NO_TRANS, Teuchos::NO_TRANS>(1.0, in, scsInterp, 0.0, temp);
+      mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, nodalDeriv, temp, 0.0, out);
     }
     //--------------------------------------------------------------------------
     template <unsigned poly_order>
     void Dy_yhat(const double* scsDeriv, const double* in, double* out)
     {
       // computes yhat-derivative at scs of constant yhat coordinate
-      mxm(Teuchos::NO_TRANS, Teuchos::NO_TRANS, poly_order+1, 1.0, in, scsDeriv,  0.0, out);
+      mxm<poly_order+1, Teuchos::NO_TRANS, Teuchos::NO_TRANS>(1.0, in, scsDeriv,  0.0, out);
     }
   }
 
-  enum Direction
-  {
-    XH = 0,
-    YH = 1
-  };
-
   template <unsigned poly_order>
   void nodal_grad(
     const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
@@ -115,10 +173,13 @@ namespace HighOrderOperators {
     const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
     const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
     const typename QuadViews<poly_order>::nodal_scalar_array& f,
-    typename QuadViews<poly_order>::nodal_vector_array& grad)
+    typename QuadViews<poly_order>::nodal_vector_array& grad,
+    ScratchWorkspace& work)
   {
     // computes reference-element at scs of constant yhat coordinate
-    QuadInternal::Dx_yhat<poly_order>(scsInterp.data(), nodalDeriv.data(), &f(0,0), &grad(XH,0,0));
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename QuadViews<poly_order>::nodal_scalar_array>();
+    QuadInternal::Dx_yhat<poly_order>(scsInterp.data(), nodalDeriv.data(), &f(0,0), &grad(XH,0,0), temp.data());
     QuadInternal::Dy_yhat<poly_order>(scsDeriv.data(), &f(0,0), &grad(YH,0,0));
   }
   //--------------------------------------------------------------------------
@@ -128,13 +189,16 @@ namespace HighOrderOperators {
     const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
     const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
     const typename QuadViews<poly_order>::nodal_vector_array& f,
-    typename QuadViews<poly_order>::nodal_tensor_array& grad)
+    typename QuadViews<poly_order>::nodal_tensor_array& grad,
+    ScratchWorkspace& work)
   {
     // computes reference-element gradient at scs of constant yhat coordinate
-    QuadInternal::Dx_yhat<poly_order>(scsInterp.data(), nodalDeriv.data(), &f(XH,0,0), &grad(XH,XH,0,0));
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename QuadViews<poly_order>::nodal_scalar_array>();
+    QuadInternal::Dx_yhat<poly_order>(scsInterp.data(), nodalDeriv.data(), &f(XH,0,0), &grad(XH,XH,0,0), temp.data());
     QuadInternal::Dy_yhat<poly_order>(scsDeriv.data(), &f(XH,0,0), &grad(XH,YH,0,0));
 
-    QuadInternal::Dx_yhat<poly_order>(scsInterp.data(), nodalDeriv.data(),&f(YH,0,0), &grad(YH,XH,0,0));
+    QuadInternal::Dx_yhat<poly_order>(scsInterp.data(), nodalDeriv.data(),&f(YH,0,0), &grad(YH,XH,0,0), temp.data());
     QuadInternal::Dy_yhat<poly_order>(scsDeriv.data(), &f(YH,0,0), &grad(YH,YH,0,0));
   }
   //--------------------------------------------------------------------------
@@ -144,11 +208,14 @@ namespace HighOrderOperators {
     const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
     const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
     const typename QuadViews<poly_order>::nodal_scalar_array& f,
-    typename QuadViews<poly_order>::nodal_vector_array& grad)
+    typename QuadViews<poly_order>::nodal_vector_array& grad,
+    ScratchWorkspace& work)
   {
     // computes reference-element gradient at scs of constant xhat coordinate
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename QuadViews<poly_order>::nodal_scalar_array>();
     QuadInternal::Dx_xhat<poly_order>(scsDeriv.data(), &f(0,0), &grad(XH,0,0));
-    QuadInternal::Dy_xhat<poly_order>(scsInterp.data(), nodalDeriv.data(), &f(0,0), &grad(YH,0,0));
+    QuadInternal::Dy_xhat<poly_order>(scsInterp.data(), nodalDeriv.data(), &f(0,0), &grad(YH,0,0), temp.data());
   }
   //--------------------------------------------------------------------------
   template <unsigned poly_order>
@@ -157,13 +224,16 @@ namespace HighOrderOperators {
     const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
     const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
     const typename QuadViews<poly_order>::nodal_vector_array& f,
-    typename QuadViews<poly_order>::nodal_tensor_array& grad)
+    typename QuadViews<poly_order>::nodal_tensor_array& grad,
+    ScratchWorkspace& work)
   {
     // computes reference-element gradient at scs of constant xhat coordinate
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename QuadViews<poly_order>::nodal_scalar_array>();
     QuadInternal::Dx_xhat<poly_order>(scsDeriv.data(),&f(XH,0,0), &grad(XH,XH,0,0));
-    QuadInternal::Dy_xhat<poly_order>(scsInterp.data(), nodalDeriv.data(),&f(XH,0,0), &grad(XH,YH,0,0));
+    QuadInternal::Dy_xhat<poly_order>(scsInterp.data(), nodalDeriv.data(),&f(XH,0,0), &grad(XH,YH,0,0), temp.data());
     QuadInternal::Dx_xhat<poly_order>(scsDeriv.data(),&f(YH,0,0), &grad(YH,XH,0,0));
-    QuadInternal::Dy_xhat<poly_order>(scsInterp.data(), nodalDeriv.data(),&f(YH,0,0), &grad(YH,YH,0,0));
+    QuadInternal::Dy_xhat<poly_order>(scsInterp.data(), nodalDeriv.data(),&f(YH,0,0), &grad(YH,YH,0,0), temp.data());
   }
   //--------------------------------------------------------------------------
   template <unsigned poly_order>
@@ -173,19 +243,21 @@ namespace HighOrderOperators {
     typename QuadViews<poly_order>::nodal_scalar_array& f_bar)
   {
     // computes volume integral along 1D lines (e.g. "scs" in 2D)
-    QuadInternal::mxm(Teuchos::TRANS   , Teuchos::NO_TRANS, poly_order +1, 1.0, nodalWeights.data(), &f(0,0), 0.0, &f_bar(0,0));
+    QuadInternal::mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, nodalWeights.data(), &f(0,0), 0.0, &f_bar(0,0));
   }
   //--------------------------------------------------------------------------
   template <unsigned poly_order>
   void volume_2D(
     const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalWeights,
     const typename QuadViews<poly_order>::nodal_scalar_array& f,
-    typename QuadViews<poly_order>::nodal_scalar_array& f_bar)
+    typename QuadViews<poly_order>::nodal_scalar_array& f_bar,
+    ScratchWorkspace& work)
   {
     // computes volume integral along 2D volumes (e.g. "scv" in 2D)
-    typename QuadViews<poly_order>::nodal_scalar_array temp("temp");
-    QuadInternal::mxm(Teuchos::NO_TRANS, Teuchos::NO_TRANS, poly_order +1, 1.0,  &f(0,0), nodalWeights.data(),    0.0, temp.data());
-    QuadInternal::mxm(Teuchos::TRANS   , Teuchos::NO_TRANS, poly_order +1, 1.0, nodalWeights.data(), temp.data(), 1.0, &f_bar(0,0));
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename QuadViews<poly_order>::nodal_scalar_array>();
+    QuadInternal::mxm<poly_order+1, Teuchos::NO_TRANS, Teuchos::NO_TRANS>(1.0,  &f(0,0), nodalWeights.data(),    0.0, temp.data());
+    QuadInternal::mxm<poly_order+1, Teuchos::TRANS, Teuchos::NO_TRANS>(1.0, nodalWeights.data(), temp.data(), 1.0, &f_bar(0,0));
   }
   //--------------------------------------------------------------------------
   template <unsigned poly_order>
@@ -216,6 +288,194 @@ namespace HighOrderOperators {
       residual(poly_order, m) += flux(poly_order-1, m);
     }
   }
+  //--------------------------------------------------------------------------
+  namespace QuadBatchInternal {
+    /*
+     * Contractions of a (row-major) n x n coefficient matrix M with a batch of n x n element arrays,
+     * stored with the element ("lane") index innermost.  The inner loop runs over the lanes
+     * with unit stride, so it vectorizes regardless of how small n is
+     */
+    template <int n, int lanes>
+    inline void apply_first(const double* M, const double* in, double* out)
+    {
+      // out(j,i) = sum_k M(j,k) in(k,i)
+      for (int j = 0; j < n; ++j) {
+        double acc[n * lanes] = {};
+        for (int k = 0; k < n; ++k) {
+          const double m = M[j * n + k];
+          const double* f = &in[k * n * lanes];
+          for (int il = 0; il < n * lanes; ++il) {
+            acc[il] += m * f[il];
+          }
+        }
+        for (int il = 0; il < n * lanes; ++il) {
+          out[j * n * lanes + il] = acc[il];
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <int n, int lanes>
+    inline void apply_second(const double* M, const double* in, double* out, double beta)
+    {
+      // out(j,i) = beta out(j,i) + sum_k in(j,k) M(i,k)
+      for (int j = 0; j < n; ++j) {
+        double acc[n][lanes] = {};
+        for (int k = 0; k < n; ++k) {
+          const double* f = &in[(j * n + k) * lanes];
+          for (int i = 0; i < n; ++i) {
+            const double m = M[i * n + k];
+            for (int l = 0; l < lanes; ++l) {
+              acc[i][l] += m * f[l];
+            }
+          }
+        }
+        for (int i = 0; i < n; ++i) {
+          double* o = &out[(j * n + i) * lanes];
+          for (int l = 0; l < lanes; ++l) {
+            o[l] = beta * o[l] + acc[i][l];
+          }
+        }
+      }
+    }
+    //--------------------------------------------------------------------------
+    template <int n, int lanes>
+    inline void apply_second_transpose(const double* M, const double* in, double* out)
+    {
+      // out(j,i) = sum_k M(j,k) in(i,k)
+      for (int i = 0; i < n; ++i) {
+        double acc[n][lanes] = {};
+        for (int k = 0; k < n; ++k) {
+          const double* f = &in[(i * n + k) * lanes];
+          for (int j = 0; j < n; ++j) {
+            const double m = M[j * n + k];
+            for (int l = 0; l < lanes; ++l) {
+              acc[j][l] += m * f[l];
+            }
+          }
+        }
+        for (int j = 0; j < n; ++j) {
+          double* o = &out[(j * n + i) * lanes];
+          for (int l = 0; l < lanes; ++l) {
+            o[l] = acc[j][l];
+          }
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_xhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& f,
+    typename QuadBatchViews<poly_order>::nodal_vector_array& grad,
+    ScratchWorkspace& work)
+  {
+    // batched reference-element gradient at scs of constant xhat coordinate
+    using BatchView = QuadBatchViews<poly_order>;
+    constexpr int n = BatchView::nodes1D;
+    constexpr int lanes = BatchView::lanes;
+
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename BatchView::nodal_scalar_array>();
+    QuadBatchInternal::apply_second_transpose<n, lanes>(scsDeriv.data(), f.data(), &grad(XH,0,0,0));
+    QuadBatchInternal::apply_second_transpose<n, lanes>(scsInterp.data(), f.data(), temp.data());
+    QuadBatchInternal::apply_second<n, lanes>(nodalDeriv.data(), temp.data(), &grad(YH,0,0,0), 0.0);
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scs_yhat_grad(
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsInterp,
+    const typename CoefficientViews<poly_order>::scs_matrix_array& scsDeriv,
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalDeriv,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& f,
+    typename QuadBatchViews<poly_order>::nodal_vector_array& grad,
+    ScratchWorkspace& work)
+  {
+    // batched reference-element gradient at scs of constant yhat coordinate
+    using BatchView = QuadBatchViews<poly_order>;
+    constexpr int n = BatchView::nodes1D;
+    constexpr int lanes = BatchView::lanes;
+
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename BatchView::nodal_scalar_array>();
+    QuadBatchInternal::apply_first<n, lanes>(scsInterp.data(), f.data(), temp.data());
+    QuadBatchInternal::apply_second<n, lanes>(nodalDeriv.data(), temp.data(), &grad(XH,0,0,0), 0.0);
+    QuadBatchInternal::apply_first<n, lanes>(scsDeriv.data(), f.data(), &grad(YH,0,0,0));
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void volume_1D(
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalWeights,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& f,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& f_bar)
+  {
+    // batched volume integral along 1D lines
+    using BatchView = QuadBatchViews<poly_order>;
+    QuadBatchInternal::apply_second<BatchView::nodes1D, BatchView::lanes>(
+      nodalWeights.data(), f.data(), f_bar.data(), 0.0);
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void volume_2D(
+    const typename CoefficientViews<poly_order>::nodal_matrix_array& nodalWeights,
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& f,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& f_bar,
+    ScratchWorkspace& work)
+  {
+    // batched volume integral over 2D volumes, added to f_bar
+    using BatchView = QuadBatchViews<poly_order>;
+    constexpr int n = BatchView::nodes1D;
+    constexpr int lanes = BatchView::lanes;
+
+    ScratchScope scope(work);
+    auto temp = work.get_view<typename BatchView::nodal_scalar_array>();
+    QuadBatchInternal::apply_first<n, lanes>(nodalWeights.data(), f.data(), temp.data());
+    QuadBatchInternal::apply_second<n, lanes>(nodalWeights.data(), temp.data(), f_bar.data(), 1.0);
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scatter_flux_xhat(
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& flux,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& residual)
+  {
+    constexpr int lanes = QuadBatchViews<poly_order>::lanes;
+    for (unsigned n = 0; n < poly_order+1; ++n) {
+      for (int l = 0; l < lanes; ++l) {
+        residual(n,0,l) -= flux(0,n,l);
+      }
+      for (unsigned p = 1; p < poly_order; ++p) {
+        for (int l = 0; l < lanes; ++l) {
+          residual(n,p,l) -= flux(p,n,l) - flux(p-1,n,l);
+        }
+      }
+      for (int l = 0; l < lanes; ++l) {
+        residual(n,poly_order,l) += flux(poly_order-1,n,l);
+      }
+    }
+  }
+  //--------------------------------------------------------------------------
+  template <unsigned poly_order>
+  void scatter_flux_yhat(
+    const typename QuadBatchViews<poly_order>::nodal_scalar_array& flux,
+    typename QuadBatchViews<poly_order>::nodal_scalar_array& residual)
+  {
+    constexpr int lanes = QuadBatchViews<poly_order>::lanes;
+    for (unsigned m = 0; m < poly_order+1; ++m) {
+      for (int l = 0; l < lanes; ++l) {
+        residual(0,m,l) -= flux(0,m,l);
+      }
+      for (unsigned p = 1; p < poly_order; ++p) {
+        for (int l = 0; l < lanes; ++l) {
+          residual(p,m,l) -= flux(p,m,l) - flux(p-1,m,l);
+        }
+      }
+      for (int l = 0; l < lanes; ++l) {
+        residual(poly_order,m,l) += flux(poly_order-1,m,l);
+      }
+    }
+  }
 
 }
 } // namespace naluUnit
@@ -0,0 +1,48 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef KrylovSolvers_h
+#define KrylovSolvers_h
+
+#include <functional>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+  // y = A x for an operator that is only available through its action
+  using LinearOperator = std::function<void(const std::vector<double>& x, std::vector<double>& y)>;
+
+  struct KrylovResult
+  {
+    int iterations;
+    double relativeResidual;
+    bool converged;
+  };
+
+  // preconditioned conjugate gradient, for symmetric positive-definite operators
+  KrylovResult preconditioned_cg(
+    const LinearOperator& A,
+    const LinearOperator& preconditioner,
+    const std::vector<double>& b,
+    std::vector<double>& x,
+    double tolerance,
+    int maxIterations);
+
+  // restarted, right-preconditioned GMRES
+  KrylovResult preconditioned_gmres(
+    const LinearOperator& A,
+    const LinearOperator& preconditioner,
+    const std::vector<double>& b,
+    std::vector<double>& x,
+    double tolerance,
+    int maxIterations,
+    int restart = 50);
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
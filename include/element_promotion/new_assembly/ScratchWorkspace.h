@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef ScratchWorkspace_h
+#define ScratchWorkspace_h
+
+#include <stddef.h>
+#include <vector>
+
+namespace sierra {
+namespace naluUnit {
+
+  class ScratchWorkspace
+  {
+    /*
+     * A bump allocator for the temporary arrays of the tensor-product kernels.
+     * Views are handed out as unmanaged views on a preallocated buffer, so that
+     * no heap allocation occurs once the workspace has grown to its high-water mark.
+     *
+     * Not thread-safe: each thread should have its own workspace
+     */
+  public:
+    explicit ScratchWorkspace(size_t initialSize = 0);
+
+    template <typename ViewType> ViewType get_view()
+    {
+      // statically-sized view on the next section of the buffer
+      constexpr size_t size = sizeof(typename ViewType::data_type) / sizeof(typename ViewType::value_type);
+      return ViewType(allocate(size));
+    }
+
+    double* allocate(size_t size);
+
+    // releases all outstanding views and merges any overflow blocks into a single buffer
+    void reset();
+
+    size_t capacity() const;
+    size_t num_heap_allocations() const { return numHeapAllocations_; }
+
+  private:
+    friend class ScratchScope;
+
+    std::vector<std::vector<double>> blocks_;
+    size_t currentBlock_;
+    size_t offset_;
+    size_t numHeapAllocations_;
+  };
+
+  class ScratchScope
+  {
+    // releases the views taken from the workspace during the lifetime of the scope
+  public:
+    explicit ScratchScope(ScratchWorkspace& work)
+    : work_(work),
+      block_(work.currentBlock_),
+      offset_(work.offset_) {}
+
+    ~ScratchScope()
+    {
+      work_.currentBlock_ = block_;
+      work_.offset_ = offset_;
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+  private:
+    ScratchWorkspace& work_;
+    const size_t block_;
+    const size_t offset_;
+  };
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif
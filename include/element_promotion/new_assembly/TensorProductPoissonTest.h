@@ -7,24 +7,28 @@
 #ifndef TensorProductPoissonTest_h
 #define TensorProductPoissonTest_h
 
+#include <element_promotion/new_assembly/KrylovSolvers.h>
+
 #include <stk_mesh/base/Field.hpp>
 #include <stk_mesh/base/CoordinateSystems.hpp>
-
-#include <Teuchos_SerialDenseVector.hpp>
-#include <Teuchos_SerialDenseMatrix.hpp>
-#include <Teuchos_SerialDenseSolver.hpp>
+#include <stk_mesh/base/Types.hpp>
 
 #include <stddef.h>
+#include <map>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace sierra {
 namespace naluUnit {
+  class CrsMatrix;
+  class ElementCondenser;
   class MasterElement;
   class PromoteElement;
   class PromotedElementIO;
+  class ScratchWorkspace;
   struct ElementDescription;
 }
 }
@@ -59,7 +63,11 @@ public:
  TensorProductPoissonTest(
    std::string meshName = "test_meshes/tquad4_4.g",
    int order = 10,
-   bool printTiming = true);
+   bool printTiming = true,
+   bool matrixFree = false,
+   int numThreads = 1,
+   bool condense = false,
+   bool perturbCoordinates = true);
  ~TensorProductPoissonTest();
 
   void execute();
@@ -77,21 +85,48 @@ private:
   void initialize_matrix();
   void assemble_poisson(unsigned pOrder);
   template<unsigned poly_order> void assemble_poisson();
+  template<unsigned poly_order> void assemble_poisson_quad();
+  template<unsigned poly_order> void assemble_poisson_hex();
+  template<typename TopoView> void assemble_poisson_threaded(int numThreads);
+  bool check_threaded_assembly();
+  void benchmark_thread_scaling();
+  void reset_scratch();
+  size_t count_heap_allocations() const;
+  void benchmark_generic_mxm();
+  void benchmark_batched_residual(unsigned pOrder);
+  template<unsigned poly_order> void benchmark_batched_residual();
+  void solve_matrix_free(unsigned pOrder);
+  template<unsigned poly_order> void solve_matrix_free();
+  template<typename TopoView> void setup_matrix_free();
+  template<typename TopoView> void apply_laplacian(const std::vector<double>& x, std::vector<double>& y);
+  template<typename TopoView> bool check_laplacian_diagonal();
+  template<unsigned poly_order> void batch_element_metrics();
+  template<unsigned poly_order> void apply_laplacian_batched(const std::vector<double>& x, std::vector<double>& y);
+  template<unsigned poly_order> bool check_batched_operator();
+  void solve_krylov(const LinearOperator& laplacian);
   void sum_into_global(
-    const stk::mesh::Entity* node_rels,
-    const int* nodeMap,
-    double* lhs_local,
-    double* rhs_local,
-    int length
+    size_t elem,
+    const double* lhs_local,
+    const double* rhs_local,
+    const double* axis_scales = nullptr
   );
   void apply_dirichlet();
   void solve_matrix_equation();
   void update_field();
+  void update_element_interiors(unsigned pOrder);
+  template<unsigned poly_order> void update_element_interiors();
+  template<typename TopoView> void compute_interior_updates();
+  void reorder_interior_last(const double* lhs_local, const double* rhs_local);
+  bool check_fast_diagonalization();
   void reset_global();
 
   const std::string meshName_;
   const int order_;
   const bool outputTiming_;
+  const bool matrixFree_;
+  const int numThreads_;
+  const bool condense_;
+  int activeThreads_;
   int numRuns_;
   double totalTime_;
   double timeSetup_;
@@ -104,14 +139,36 @@ private:
   double timeGather_;
   double timeVolumeMetric_;
   double timeVolumeSource_;
+  double timeMetricGenericMxm_;
+  double timeResidualGenericMxm_;
+  bool genericMxmMatches_;
+  double timeResidualScalar_;
+  double timeResidualBatched_;
   size_t countAssemblies_;
-  const double testTolerance_;
+  size_t steadyStateHeapAllocations_;
+  double timeCondense_;
+  double timeInteriorUpdate_;
+  double timeSolve_;
+  double timeOperatorApply_;
+  double timeKrylov_;
+  size_t countOperatorApply_;
+  int krylovIterations_;
+  double krylovResidual_;
+  bool krylovConverged_;
+  bool batchedOperatorMatches_;
+  bool laplacianDiagonalMatches_;
+  bool threadedAssemblyMatches_;
+  std::vector<std::pair<int, double>> threadScaling_;
+  double testTolerance_;
   const bool randomlyPerturbCoordinates_;
+  bool fastDiagonalization_;
 
   std::string fineOutputName_;
 
-  std::unique_ptr<ElementDescription> elem_;
+  std::shared_ptr<const ElementDescription> elem_;
   std::unique_ptr<PromotedElementIO> promoteIO_;
+  std::unique_ptr<ScratchWorkspace> workspace_;
+  std::vector<std::unique_ptr<ScratchWorkspace>> threadWorkspaces_;
 
   // meta, bulk, io, and promote element
   std::unique_ptr<stk::mesh::MetaData> metaData_;
@@ -129,10 +186,39 @@ private:
   stk::mesh::PartVector superPartVector_;
   stk::mesh::PartVector superSidePartVector_;
 
-  Teuchos::SerialDenseMatrix<int,double> lhs_;
-  Teuchos::SerialDenseVector<int,double> rhs_;
-  Teuchos::SerialDenseVector<int,double> delta_;
+  std::unique_ptr<CrsMatrix> lhs_;
+  std::vector<double> rhs_;
+  std::vector<double> delta_;
   std::map<stk::mesh::Entity, size_t> rowMap_;
+
+  // mesh ordinal of each element node, in tensor-product ordering
+  std::vector<int> nodeMap_;
+
+  // global row of each element node, in tensor-product ordering
+  std::vector<int> elemRows_;
+
+  // static condensation of the element interior nodes: the elemental system reordered with
+  // the interior nodes last and the condensed, boundary-only system
+  std::unique_ptr<ElementCondenser> condenser_;
+  std::vector<double> condensationLhs_;
+  std::vector<double> condensationRhs_;
+  std::vector<double> condensedLhs_;
+  std::vector<double> condensedRhs_;
+
+  // buckets of the super elements, in the order that the elements are numbered
+  stk::mesh::BucketVector elemBuckets_;
+
+  // node relations of each element and the elements of each color, for the threaded assembly
+  std::vector<const stk::mesh::Entity*> elemNodeRels_;
+  std::vector<std::vector<size_t>> elemColors_;
+
+  // matrix-free operator data: the diffusion metric for each element (also in the
+  // batched layout for quads) and the Jacobi preconditioner
+  std::vector<double> elemMetric_;
+  std::vector<double> elemMetricBatched_;
+  std::vector<double> diagonal_;
+  std::vector<double> rhsMatrixFree_;
+  std::vector<char> isDirichlet_;
 };
 
 } // namespace naluUnit
@@ -0,0 +1,30 @@
+/*------------------------------------------------------------------------*/
+/*  Copyright 2014 Sandia Corporation.                                    */
+/*  This software is released under the license detailed                  */
+/*  in the file, LICENSE, which is located in the top-level NaluUnit      */
+/*  directory structure                                                   */
+/*------------------------------------------------------------------------*/
+#ifndef ThreadedLoop_h
+#define ThreadedLoop_h
+
+#include <stddef.h>
+#include <functional>
+
+namespace sierra {
+namespace naluUnit {
+
+  // body(thread, index) for thread in [0, numThreads) and index in [0, n)
+  using ThreadedLoopBody = std::function<void(int thread, size_t index)>;
+
+  // Runs the body over [0, n) on numThreads threads, the calling thread being thread 0.
+  // The other threads are the workers of a pool: created by the first loop that needs them,
+  // they wait between loops and are joined at exit.  Indices are handed out in chunks from a
+  // shared counter, so threads that finish their chunks early take on more of the work.
+  // Exceptions are rethrown on the calling thread.  A loop started from the body of
+  // another runs serially on the thread that started it
+  void threaded_for(int numThreads, size_t n, const ThreadedLoopBody& body, size_t chunkSize = 1);
+
+} // namespace naluUnit
+} // namespace Sierra
+
+#endif